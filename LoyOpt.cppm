@@ -0,0 +1,61 @@
+/*
+ * LoyOpt.cppm
+ *
+ *  Created on: Nov 28, 2022
+ *      Author: loywong@gmail.com, github.com/loykylewong
+ *     License: MIT License, Copyright (c) 2023 Loy Kyle Wong
+ */
+
+// ==== LoyOpt module ===
+//
+// C++20 module interface of the core LoyOpt.h, "import loyopt;" instead of including it,
+// the header is parsed once when building the module, with debug info off.
+// e.g. with g++:
+//   g++ -std=c++20 -fmodules-ts -c LoyOpt.cppm
+//   g++ -std=c++20 -fmodules-ts main.cc LoyOpt.o
+// GCC 12 crashes building it (internal compiler error), use GCC 14+, Clang 16+ or MSVC 17.6+.
+// names are exported in namespace loyopt only, e.g. loyopt::Option<int32_t>,
+// macros such as LOYOPTION_CONSTINIT are not exported.
+
+module;
+
+#define LOYOPTION_VERBOSE false
+#define LOYOPTION_OBSERVER false
+#define LOYOPTION_GLOBAL_NAMES false
+#include "LoyOpt.h"
+
+export module loyopt;
+
+export namespace loyopt
+{
+    using loyopt::is_numeric_option_v;
+    using loyopt::is_list_option_v;
+    using loyopt::OptionHelp;
+    using loyopt::PerfectHash;
+    using loyopt::Choice;
+    using loyopt::ChoiceSet;
+    using loyopt::MakeChoiceSet;
+    using loyopt::MemoryCounter;
+    using loyopt::MemoryScope;
+    using loyopt::StringPool;
+#if(LOYOPTION_THREADS)
+    using loyopt::ParallelExecutor;
+    using loyopt::WorkerPool;
+#endif
+    using loyopt::OptionBase;
+    using loyopt::Option;
+    using loyopt::StaticString;
+    using loyopt::StaticOption;
+    using loyopt::NameTrie;
+    using loyopt::OptionEvent;
+    using loyopt::OptionObserver;
+    using loyopt::OptionParser;
+    using loyopt::OptionStream;
+    using loyopt::Command;
+    using loyopt::CommandSet;
+    using loyopt::Opt;
+    using loyopt::OptionSet;
+    using loyopt::OptionBlob;
+    using loyopt::OptionSnapshot;
+    using loyopt::LiveOptions;
+}
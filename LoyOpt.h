@@ -11,17 +11,40 @@
 
 #include <cstdint>
 #include <cmath>
+#include <cerrno>
+#include <charconv>
 #include <limits>
 #include <type_traits>
-#include <variant>
+#include <utility>
+#include <tuple>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <array>
 #include <vector>
+#include <initializer_list>
+#include <algorithm>
+#include <thread>
+#include <condition_variable>
 #include <string.h>
 #include <string>
-#include <sstream>
-#include <iostream>
-#include <iomanip>
-
-using namespace std;
+#include <string_view>
+#include <cstdio>
+#include <cstdlib>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define LOYOPTION_MMAP true
+extern "C" char **environ;
+#define LOYOPTION_ENVIRON environ
+#else
+#define LOYOPTION_MMAP false
+#define LOYOPTION_ENVIRON _environ
+#endif
 
 // ==== LoyOption ===
 //
@@ -29,6 +52,15 @@ using namespace std;
 // with option status checking, default value, clamping and kinds of value type.
 //
 // Compile with -std=c++17
+//
+// Headers:
+//   * LoyOpt.h     : the core, options and parsers, without iostream, all in namespace loyopt,
+//                    with using-declarations of it's classes at global scope (see
+//                    LOYOPTION_GLOBAL_NAMES), names of std are always qualified, even inside it,
+//                    so "using namespace loyopt;" brings no names of std.
+//   * LoyOptHelp.h : optional iostream helpers, operator<< of help text, PrintHelp(),
+//                    and StreamObserver() printing parsing events to an ostream.
+//   * LoyOpt.cppm  : C++20 module interface "loyopt" of the core, for "import loyopt;".
 // 
 // Features:
 //   * support bool, string, and numeric options.
@@ -37,17 +69,39 @@ using namespace std;
 //   * support status check for:
 //       * option(s) not parsed (unsupported option(s)).
 //       * invalid or missing option value (not parsalbe).
+//       * option value out of range of the value type (overflow).
 // Class:
 //   * OptionBase   : base class of Option, a vector<OptionBase *> can be used to
 //                    collect all your instances of Option for easy iterating.
 //   * Option<T>    : define an option, use for later args parsing, result and status storing.
-//   * OptionParser : constructed with argv and args, parsing args by using instances of Option.
+//   * StaticOption : an Option<T> with constexpr definition (names, default, range, help lines),
+//                    constant initialized as a global, without static initialization cost.
+//   * OptionParser : constructed with argv and args, parsing args by using instances of Option,
+//                    one by one with Parse(), or all in a single pass with ParseAll().
+//   * ChoiceSet    : allowed names of a choice option Option<E> of an enum type E,
+//                    looked up by a constexpr perfect hash table (PerfectHash).
+//   * OptionSet    : a set of options defined at compile time, parsing args of an OptionParser
+//                    by a constexpr perfect hash table of option names.
+//   * OptionStream : parsing options incrementally from input in chunks, such as a pipe,
+//                    matching each token once it's completed, in memory of the largest token.
+//   * CommandSet   : subcommands, dispatching to the one named by the 1st unparsed arg,
+//                    whose options are constructed and parsed only when it's used.
+//   * LiveOptions  : hot-reloadable snapshots of options, re-parsing args into a new snapshot
+//                    and publishing it atomically, for lock-free readers in other threads.
+//   * OptionBlob   : a versioned binary blob of parsed options with a schema hash,
+//                    for loading them in worker processes without re-parsing args.
+//   * MemoryScope  : a std::pmr::memory_resource for storage of options and parsers constructed
+//                    in it's scope, such as a monotonic arena, see MemoryCounter for sizing it.
+//   * StringPool   : interned read-only strings in shared blocks, names and help lines of
+//                    options are stored once however many options have them.
+//   * WorkerPool   : threads started once and reused for parsing long list values in parallel,
+//                    or a caller's pool as a ParallelExecutor, see SetParallel().
 // Supported option types:
 //   * bool : in the form such as:
 //       * -c    : single letter/digit with prefix '-' as it's name.
 //       * --str : multiple chars (starts with letter/digit) with prefix "--" as it's name.
 //     default value is false, when name exists in args, it will be parsed as true.
-//   * string : in the form such as:
+//   * string : Option<string>, or Option<pmr::string> with storage from MemoryScope, in the form such as:
 //       * -c value    : single letter/digit with prefix '-' as it's name.
 //                       flowing a space and a string as it's value.
 //       * --str value : multiple chars (starts with letter/digit) with prefix "--" as it's name.
@@ -62,509 +116,4482 @@ using namespace std;
 //                       flowing a space and a numeric literal string as it's value.
 //     note:
 //       * supported numeric type: int32_t, uint32_t, int64_t, float and double.
+//       * a float or double literal too small for the type is 0 or a denormal, like strtod(),
+//         too large is ValueOverflow.
+//       * a literal out of range of the type is clamped as ClampedMax or ClampedMin if the option
+//         has a narrower max or min on that side, such as "3000000000" of an int32_t in [0, 100],
+//         and ValueOverflow otherwise.
+//       * leading white spaces of a value are skipped, as strtoll() and strtod(), such as " 5".
+//       * with SetUnit(), an integer option takes a unit suffix, such as "64K", "2GiB" as Bytes,
+//         or "150ms", "5m" as Milliseconds, see OptionBase::Unit, the suffix follows all
+//         digits of the base, optionally after '_', such as "0x1_B" in hex.
+//   * choice : Option<E> of an enum type E with a ChoiceSet, such as "--mode fast",
+//     value is one of names in the ChoiceSet, others are ValueInvalid.
 // Remark:
 //   * all space in args can be one or more ' '.
 //   * if an option repeat in args, first one take priority and leave others unparsed.
 //   * multiple bool options with single '-' prefix and single char, can be merged,
 //     such as "-a -b -c" can be merged as "-abc", the fisrt char must not be a digit.
+//   * a string or numeric option can also be in the form "--str=value" or "-cvalue",
+//     or following merged bool options, such as "-abcvalue" for bool "-a", "-b" and "-c value".
+//   * merged short flags or "--str=value" not parsed at all are left unparsed as a whole,
+//     such as "--unknown=1", otherwise the flags not parsed are left unparsed one by one.
 //   * option name starts without '-' is allowed, but not recommended.
 //   * option name "-" and "--" is allowed, but may cause undefined behavior.
+//   * with rsp_depth > 0 in OptionParser's constructor, "@path" args are expanded as tokens
+//     in response file "path", with the same quoting and "\ " escaping as above,
+//     and can be nested up to rsp_depth levels, the file is memory-mapped and not copied.
+//   * after OptionParser::LoadEnv(prefix), an option not found in args is taken from environment
+//     variable prefix + it's name in upper case without leading '-' and with '-' as '_', such as
+//     "LOYOPT_INT32_G" for "--int32_g" with prefix "LOYOPT_", and GetSource() is FromEnv.
+//   * after OptionParser::LoadConfig(path), an option not found in args nor environment is taken
+//     from line "name = value" of the config file, such as "int32_g = 100" for "--int32_g",
+//     or "port = 80" after "[net]" for "--net.port", and GetSource() is FromFile.
+//   * FormatValue() and AppendValueTo() format values by to_chars() into a caller's buffer,
+//     OptionBase::AppendAllValuesTo() dumps "name=value" lines of all options at once.
+//   * OptionParser::Complete() answers "prog --complete [words...] partial" of shell completion
+//     with names (or choices) by a trie lookup without parsing, and prints completion scripts
+//     calling it for bash, zsh and fish.
+//   * within a MemoryScope, storage of options and parsers is from it's memory_resource,
+//     except values of Option<string> and list options, see OptionParser::BytesUsed().
+//   * names and HelpLines of options are interned in StringPool::Shared() (or the pool of a
+//     MemoryScope), each distinct one is stored once, options of the same definition share them,
+//     HelpLines is a read-only OptionHelp, assigned as a whole (such as = {"line 1", "line 2"}),
+//     by push_back() or clear(), instead of a vector<string>.
+//   * an OptionStream parses options from a pipe or socket chunk by chunk, Feed() then Finish(),
+//     tokenized as a response file, each token is matched once it's completed.
+
+// for debug, define it as true before including this file to print debug info of parsing.
+#ifndef LOYOPTION_VERBOSE
+#define LOYOPTION_VERBOSE false
+#endif
+
+// emit parsing events to an OptionObserver, see OptionParser::SetObserver(),
+// debug info is printed by the default observer with LOYOPTION_VERBOSE,
+// define it as true before including this file to observe events, all events compile to nothing
+// by default (false unless LOYOPTION_VERBOSE).
+#ifndef LOYOPTION_OBSERVER
+#define LOYOPTION_OBSERVER LOYOPTION_VERBOSE
+#endif
+#if(LOYOPTION_VERBOSE && !LOYOPTION_OBSERVER)
+#error "LOYOPTION_VERBOSE requires LOYOPTION_OBSERVER"
+#endif
+
+// declare classes of namespace loyopt at global scope, such as Option for loyopt::Option,
+// define it as false before including this file to keep global namespace clean.
+#ifndef LOYOPTION_GLOBAL_NAMES
+#define LOYOPTION_GLOBAL_NAMES true
+#endif
+
+// constinit with C++20, for a global StaticOption to be ensured constant initialized.
+#if defined(__cpp_constinit)
+#define LOYOPTION_CONSTINIT constinit
+#else
+#define LOYOPTION_CONSTINIT
+#endif
+
+// parse and format floating point values with std::from_chars() and std::to_chars(),
+// locale independent, define it as false before including this file to fall back to
+// strtod() and snprintf(), for toolchains without floating point std::from_chars().
+#ifndef LOYOPTION_FROM_CHARS_FLOAT
+#if defined(__cpp_lib_to_chars)
+#define LOYOPTION_FROM_CHARS_FLOAT true
+#else
+#define LOYOPTION_FROM_CHARS_FLOAT false
+#endif
+#endif
+
+// parse very long list option values by multiple threads, see Option<vector<E>>::SetParallel(),
+// define it as false before including this file to parse them in the calling thread only.
+#ifndef LOYOPTION_THREADS
+#define LOYOPTION_THREADS true
+#endif
 
-// for debug
-#define LOYOPTION_VERBOSE true
+namespace loyopt
+{
 
 class OptionParser;
+template<typename... Opts> class OptionSet;
+class LiveOptions;
+class OptionSnapshot;
+class OptionBlob;
+class OptionStream;
 
-class OptionBase
+template<typename E>
+inline constexpr bool is_numeric_option_v = std::is_same_v<E, int32_t> || std::is_same_v<E, uint32_t> ||
+        std::is_same_v<E, int64_t> || std::is_same_v<E, float> || std::is_same_v<E, double>;
+template<typename T>
+inline constexpr bool is_list_option_v = false;
+template<typename E>
+inline constexpr bool is_list_option_v<std::vector<E>> = is_numeric_option_v<E>;
+
+class StringPool;
+
+// OptionHelp: help lines of an option, constexpr ones of a StaticOption from an array with
+// static storage, or HelpLines of an Option interned in a StringPool by push_back(), e.g.
+//   static constexpr string_view f_help[] = { "line 1 of help info.", "line 2 of help info." };
+//   opt.HelpLines = { "line 1 of help info.", "line 2 of help info." };
+// lines are read-only views, such as for(string_view line : opt.HelpLines),
+// change them by assigning all lines, push_back() or clear().
+struct OptionHelp
 {
-    friend class OptionParser;
-protected:
-    using Val = variant<bool, string, int32_t, uint32_t, int64_t, float, double>;
-public:
-    enum Status : uint32_t
-    {
-        NotParsed     = 0, // has not been tried parsing from args.
-        NotFound         , // has been tried parsing from args, but not found.
-        ValueInvalid     , // has been tried parsing from args, but followed with invalid value.
-        ValueNotFound    , // has been tried parsing from args, but without following value.
-        ClampedMax       , // has been parsed from args, and updated value with max since overflow.
-        ClampedMin       , // has been parsed from args, and updated value with min since underflow.
-        Parsed             // has been parsed from args, and updated value.
-    };
-    // is option name exist in args?
-    inline bool IsNameExist()
+    const std::string_view *lines = nullptr;
+    size_t num = 0;
+    StringPool *pool = nullptr;     // where lines are interned, StringPool::Shared() if nullptr.
+    constexpr OptionHelp() = default;
+    constexpr explicit OptionHelp(StringPool *pool) : pool(pool) {}
+    template<size_t N>
+    constexpr OptionHelp(const std::string_view (&l)[N]) : lines(l), num(N) {}
+    constexpr OptionHelp(const std::string_view *lines, size_t num) : lines(lines), num(num) {}
+    constexpr size_t size() const { return num; }
+    constexpr bool empty() const { return num == 0; }
+    constexpr std::string_view operator[](size_t i) const { return lines[i]; }
+    constexpr const std::string_view *begin() const { return lines; }
+    constexpr const std::string_view *end() const { return lines + num; }
+    // append a line, the line and the array of lines are interned in pool,
+    // so that options with the same help lines share them.
+    void push_back(std::string_view line);
+    // replace all lines with lines, interned as by push_back().
+    OptionHelp &operator=(std::initializer_list<std::string_view> lines)
     {
-        return status != NotParsed && status != NotFound;
+        clear();
+        for(std::string_view line : lines)
+            push_back(line);
+        return *this;
     }
-    // is option value updated ?
-    // (option name exist and option value is in range or clamped into range)
-    inline bool IsValueUpdated()
+    void clear()
     {
-        return status == Parsed || status == ClampedMax || status == ClampedMin;
+        lines = nullptr;
+        num = 0;
     }
+};
 
-protected:
-    inline static const string sts_str[8]     // human readable status string.
-    {
-        "Opt Not Parsed"s, "Opt Not Found "s,
-        "Value Invalid "s, "Value NotFound"s,
-        "Clamped To Max"s, "Clamped To Min"s,
-        "Parsed Success"s, ""s
-    };
-    Status status = NotParsed;                // status of this option.
-    string name;                              // name of option, such as "-a", "--str"
-    string alt_name;                          // alternative name, such as "-b", "--str2"
-    const string *matched_name = &sts_str[7]; // last matched name, name or alt_name
-    int base = 10;                            // base of numeric option's value, 2-36, normally 2, 8, 10 and 16.
-    Val default_val;                          // default value when there is
-    Val value;                                // value equal to default_val before parsed.
-    Val min;                                  // minimal allowed value.
-    Val max;                                  // maximal allowed value.
-public:
-    vector<string> HelpLines;  // user define help info, will be output formatted by AppendHelpLinesTo().
-protected:
-    template<typename U, typename T>
-    inline T clamp(U val, T min, T max)
+// PerfectHash: a constexpr perfect hash table of N string keys (empty keys are skipped),
+// built at compile time by hash and displace: keys are grouped into buckets by hash,
+// then for buckets from the largest, find a displacement that puts all keys of the bucket
+// into free slots, so that a lookup is one hash and one compare.
+template<size_t N>
+class PerfectHash
+{
+    static_assert(N > 0 && N < 0xffff, "number of keys of a PerfectHash must be in [1, 65534].");
+    static constexpr size_t log2_ceil(size_t n)
     {
-        status = val < min ? ClampedMin : val > max ? ClampedMax : Parsed;
-        return (T)(val < min ? min : val > max ? max : val);
+        size_t l = 0;
+        while((size_t)1 << l < n)
+            l++;
+        return l;
     }
-    template<typename T>
-    void update_numeric_value_n_status(const T &val)
+    static constexpr size_t num_buckets = (size_t)1 << log2_ceil(N);
+    static constexpr size_t table_bits  = log2_ceil(num_buckets * 2);
+    static constexpr size_t table_size  = (size_t)1 << table_bits;
+    static constexpr size_t bucket_of(uint64_t h) { return (size_t)h & (num_buckets - 1); }
+    static constexpr size_t slot_of(uint64_t h, uint32_t disp)
     {
-        switch (value.index())
-        {
-        case 2: value = clamp(val, get<int32_t>(min), get<int32_t>(max));
-            break;
-        case 3: value = clamp(val, get<uint32_t>(min), get<uint32_t>(max));
-            break;
-        case 4: value = clamp(val, get<int64_t>(min), get<int64_t>(max));
-            break;
-        case 5: value = clamp(val, get<float>(min), get<float>(max));
-            break;
-        case 6: value = clamp(val, get<double>(min), get<double>(max));
-            break;
-        default: value = val; status = Parsed;
-            break;
-        }
+        return (size_t)(((h ^ disp) * 0x9e3779b97f4a7c15ull) >> (64 - table_bits));
     }
+    uint32_t disp[num_buckets] = {};    // displacement of each bucket.
+    uint16_t entry[table_size] = {};    // 1 + index in keys, 0 for empty slot.
+    bool unique = false;                // false if any key is duplicated.
 public:
-    virtual ~OptionBase() = default;
-    bool NameMatch(const string &name) 
+    // FNV-1a
+    static constexpr uint64_t Hash(std::string_view str)
     {
-        if(this->name == name)
+        uint64_t h = 14695981039346656037ull;
+        for(char c : str)
         {
-            this->matched_name = &this->name;
-            return true;
+            h ^= (uint8_t)c;
+            h *= 1099511628211ull;
         }
-        else if(this->alt_name == name)
+        return h;
+    }
+    // build the table of keys, IsUnique() is false if any key is duplicated.
+    constexpr PerfectHash(const std::string_view (&keys)[N])
+    {
+        uint64_t hs[N] = {};
+        size_t bucket_size[num_buckets] = {};
+        size_t bucket_start[num_buckets + 1] = {};
+        size_t members[N] = {};     // key indices sorted by bucket.
+        size_t slots[N] = {};       // slots of a bucket's keys with a displacement.
+        size_t max_size = 0;
+        for(size_t n = 0; n < N; n++)
         {
-            this->matched_name = &this->alt_name;
-            return true;
+            if(keys[n].empty())
+                continue;
+            hs[n] = Hash(keys[n]);
+            size_t sz = ++bucket_size[bucket_of(hs[n])];
+            max_size = sz > max_size ? sz : max_size;
         }
-        else
+        for(size_t b = 0; b < num_buckets; b++)
+            bucket_start[b + 1] = bucket_start[b] + bucket_size[b];
+        size_t fill[num_buckets] = {};
+        for(size_t n = 0; n < N; n++)
+            if(!keys[n].empty())
+                members[bucket_start[bucket_of(hs[n])] + fill[bucket_of(hs[n])]++] = n;
+        for(size_t j = 0; j < bucket_start[num_buckets]; j++)
+            for(size_t k = bucket_start[bucket_of(hs[members[j]])]; k < j; k++)
+                if(keys[members[k]] == keys[members[j]])
+                    return;     // never able to place duplicated keys.
+        unique = true;
+        for(size_t sz = max_size; sz > 0; sz--)
         {
-            return false;
+            for(size_t b = 0; b < num_buckets; b++)
+            {
+                if(bucket_size[b] != sz)
+                    continue;
+                const size_t *m = members + bucket_start[b];
+                for(uint32_t d = 0; ; d++)
+                {
+                    bool ok = true;
+                    for(size_t j = 0; ok && j < sz; j++)
+                    {
+                        slots[j] = slot_of(hs[m[j]], d);
+                        ok = entry[slots[j]] == 0;
+                        for(size_t k = 0; ok && k < j; k++)
+                            ok = slots[k] != slots[j];
+                    }
+                    if(!ok)
+                        continue;
+                    disp[b] = d;
+                    for(size_t j = 0; j < sz; j++)
+                        entry[slots[j]] = (uint16_t)(m[j] + 1);
+                    break;
+                }
+            }
         }
-    }    
-    Status GetStatus() const { return status; }
-    const string &GetName() const { return name; }
-    const string &GetAltName() const { return alt_name; }
-    const string &GetLastMatchedName() const { return *matched_name; }
-    const string &GetStatusString() const { return sts_str[(uint32_t)status]; }
-    int Base() const { return base; }
-    virtual string GetValueString(const char *fmt = nullptr) const = 0;
-    virtual string GetDefaultValueString(const char *fmt = nullptr) const = 0;
-    virtual string GetMinValueString(const char *fmt = nullptr) const = 0;
-    virtual string GetMaxValueString(const char *fmt = nullptr) const = 0;
-    virtual void AppendHelpLinesTo(stringstream &ss) const = 0;
-#if(LOYOPTION_VERBOSE)
-    virtual string GetStatusNameAndValueString() const = 0;
-#endif
+    }
+    constexpr bool IsUnique() const { return unique; }
+    // return 1 + index in keys (the ones the table built of) of str, 0 if not a key.
+    constexpr size_t Find(const std::string_view (&keys)[N], std::string_view str) const
+    {
+        const uint64_t h = Hash(str);
+        const size_t e = entry[slot_of(h, disp[bucket_of(h)])];
+        return e && keys[e - 1] == str ? e : 0;
+    }
 };
 
-// OptionDefine: define an option, will be used by OptionParser.Parse() for parsing args.
-template <typename T, typename = enable_if_t< is_same_v<T, bool> || is_same_v<T, string> ||
-        is_same_v<T, int32_t> || is_same_v<T, uint32_t> || is_same_v<T, int64_t> ||
-        is_same_v<T, float> || is_same_v<T, double> > >
-class Option : public OptionBase
+// Choice: a spelling in args of value of a choice option Option<E>, E is an enum type.
+template<typename E>
+struct Choice
 {
-    friend class OptionParser;
-public:
-    const T &Value()        const { return get<T>(value); }
-    const T &DefaultValue() const { return get<T>(default_val); }
-    const T &Min()          const { return get<T>(min); }
-    const T &Max()          const { return get<T>(max); }
-    void SetValue(T val)          { value = val; }
-    virtual ~Option() = default;
-    Option() = delete;
-    Option(const Option<T> &) = delete;
-    Option(Option<T> &&) = delete;
-    
-    // construct a bool type instance.
-    //   * name     : name of the option, such as "-r", "--rst".
-    //   * alt_name : alterative name of the option, such as "--reset".
-    template<typename U = T, typename = enable_if_t<is_same_v<U, bool>>>
-    Option(const string &name, const string &alt_name = "")
+    std::string_view name;
+    E value;
+};
+
+// ChoiceSet: allowed spellings of a choice option Option<E>, looked up by a PerfectHash built
+// at compile time, it must outlive options of it, so define it static constexpr, e.g.:
+//   enum class Mode { Fast, Safe, Bulk };
+//   static constexpr auto mode_choices = MakeChoiceSet<Mode>({
+//           {"fast", Mode::Fast}, {"safe", Mode::Safe}, {"bulk", Mode::Bulk} });
+//   Option<Mode> opt_mode(Mode::Safe, mode_choices, "--mode");
+template<typename E, size_t N>
+class ChoiceSet
+{
+    static_assert(std::is_enum_v<E>, "value type of a ChoiceSet must be an enum type.");
+    std::string_view names[N];
+    E values[N];
+    PerfectHash<N> table;
+    template<size_t... I>
+    constexpr ChoiceSet(const Choice<E> (&choices)[N], std::index_sequence<I...>)
+        : names{ choices[I].name... }, values{ choices[I].value... }, table(names)
     {
-        this->name = name;
-        this->alt_name = alt_name;
-        this->default_val = false;
-        this->value = false;
-        this->min = numeric_limits<T>::lowest();
-        this->max = numeric_limits<T>::max();
+        if(!table.IsUnique())
+            throw "names in a ChoiceSet must be unique.";   // not a constant expression.
     }
-    // construct a non-bool type instance.
-    //   * default_val : default value, used as value when
-    //       * args has not been parsed for the option, or
-    //       * option is not found in args, or
-    //       * option value is missing or invalid.
-    //   * name     : name of the option, such as "-r", "--rst".
-    //   * alt_name : alterative name of the option, such as "--reset".
-    template<typename U = T, typename = enable_if_t<
-            is_same_v<U, string>  || is_same_v<U, int32_t> || is_same_v<U, uint32_t> ||
-            is_same_v<U, int64_t> || is_same_v<U, float>   || is_same_v<U, double> >>
-    Option(const T &default_val, 
-            const string &name, const string &alt_name = "")
+public:
+    constexpr ChoiceSet(const Choice<E> (&choices)[N]) : ChoiceSet(choices, std::make_index_sequence<N>()) {}
+    constexpr size_t Size() const { return N; }
+    constexpr const std::string_view *Names() const { return names; }
+    constexpr const E *Values() const { return values; }
+    // return 1 + index of the name, 0 if it's not allowed.
+    constexpr size_t Find(std::string_view name) const { return table.Find(names, name); }
+};
+// return a ChoiceSet of choices, with N deduced, see ChoiceSet.
+template<typename E, size_t N>
+constexpr ChoiceSet<E, N> MakeChoiceSet(const Choice<E> (&choices)[N]) { return ChoiceSet<E, N>(choices); }
+
+// StringPool: interned read-only strings, and arrays of them, in shared contiguous blocks,
+// each distinct string (or array) is stored once and never freed until the pool is destructed,
+// so that names and help lines duplicated across options, such as the options of each instance
+// of a plugin, take no more memory, see Shared(), thread safe.
+class StringPool
+{
+    struct Region
     {
-        this->name = name;
-        this->alt_name = alt_name;
-        this->default_val = default_val;
-        this->value = default_val;
-        this->min = numeric_limits<T>::lowest();
-        this->max = numeric_limits<T>::max();
-    }
-    // construct a integer(no bool) or floating type instance.
-    //   * default_val : default value, used as value when
-    //       * args has not been parsed for the option, or
-    //       * option is not found in args, or
-    //       * option value is missing or invalid.
-    //   * min      : minimal value allowed, used when parsed value is less then it.
-    //   * max      : maximal value allowed, used when parsed value is larger then it.
-    //   * name     : name of the option, such as "-r", "--rst".
-    //   * alt_name : alterative name of the option, such as "--reset".
-    template<typename U = T, typename = enable_if_t<
-            is_same_v<U, int32_t> || is_same_v<U, uint32_t> || is_same_v<U, int64_t> ||
-            is_same_v<U, float>   || is_same_v<U, double> >>
-    Option(T default_val, T min, T max, 
-            const string &name, const string &alt_name = "")
+        char *cur = nullptr;
+        char *end = nullptr;
+    };
+    std::pmr::memory_resource *upstream;
+    std::pmr::vector<std::pair<char *, size_t>> blocks;   // allocated from upstream.
+    // bump regions of chars and of arrays, separated so that an array appended by Append()
+    // is extended in place when it's the last one, without copying it.
+    Region chars, arrays;
+    std::pmr::vector<std::string_view> strs;  // hash table of strings, nullptr data for a free slot.
+    std::pmr::vector<OptionHelp> arrs;        // hash table of arrays, nullptr lines for a free slot.
+    size_t num_strs = 0, num_arrs = 0;
+    size_t bytes_requested = 0;     // bytes of all strings and arrays interned.
+    size_t bytes_stored = 0;        // bytes of distinct strings and arrays stored.
+    mutable std::mutex mtx;
+    static constexpr size_t block_size = 16 << 10;
+    char *alloc(Region &r, size_t size, size_t align)
     {
-        this->name = name;
-        this->alt_name = alt_name;
-        this->default_val = default_val;
-        this->value = default_val;
-        this->min = min;
-        this->max = max;
+        char *p = (char *)(((uintptr_t)r.cur + align - 1) & ~(uintptr_t)(align - 1));
+        if(!r.cur || p > r.end || size > (size_t)(r.end - p))
+        {
+            const size_t n = std::max(block_size, size);
+            p = (char *)upstream->allocate(n, alignof(max_align_t));
+            blocks.push_back({p, n});
+            r.end = p + n;
+        }
+        r.cur = p + size;
+        bytes_stored += size;
+        return p;
     }
-    // construct a integer(no bool) or floating type instance.
-    //   * default_val : default value, used as value when
-    //       * args has not been parsed for the option, or
-    //       * option is not found in args, or
-    //       * option value is missing or invalid.
-    //   * base     : base of the value literal in args, 2~36, commonly 2, 8, 10 and 16.
-    //   * name     : name of the option, such as "-r", "--rst".
-    //   * alt_name : alterative name of the option, such as "--reset".
-    template<typename U = T, typename = enable_if_t<
-            is_same_v<U, int32_t> || is_same_v<U, uint32_t> || is_same_v<U, int64_t> ||
-            is_same_v<U, float>   || is_same_v<U, double> >>
-    Option(T default_val, int base, 
-            const string &name, const string &alt_name = "")
+    // hash of an array of interned strings, by their addresses and sizes.
+    static uint64_t hash_step(uint64_t h, std::string_view s)
     {
-        base = base <  2 ?  2 :
-               base > 36 ? 36 : base;
-        this->name = name;
-        this->alt_name = alt_name;
-        this->base = base;
-        this->default_val = default_val;
-        this->value = default_val;
-        this->min = numeric_limits<T>::lowest();
-        this->max = numeric_limits<T>::max();
+        h = (h ^ (uintptr_t)s.data()) * 0x9e3779b97f4a7c15ull;
+        return (h ^ s.size()) * 0x9e3779b97f4a7c15ull;
     }
-    // construct a integer(no bool) or floating type instance.
-    //   * default_val : default value, used as value when
-    //       * args has not been parsed for the option, or
-    //       * option is not found in args, or
-    //       * option value is missing or invalid.
-    //   * base     : base of the value literal in args, 2~36, commonly 2, 8, 10 and 16.
-    //   * min      : minimal value allowed, used when parsed value is less then it.
-    //   * max      : maximal value allowed, used when parsed value is larger then it .
-    //   * name     : name of the option, such as "-r", "--rst".
-    //   * alt_name : alterative name of the option, such as "--reset".
-    template<typename U = T, typename = enable_if_t<
-            is_same_v<U, int32_t> || is_same_v<U, uint32_t> || is_same_v<U, int64_t> ||
-            is_same_v<U, float>   || is_same_v<U, double> >>
-    Option(T default_val, int base, T min, T max, 
-            const string &name, const string &alt_name = "")
+    static uint64_t hash_of(OptionHelp a)
     {
-        base = base <  2 ?  2 :
-               base > 36 ? 36 : base;
-        this->name = name;
-        this->alt_name = alt_name;
-        this->base = base;
-        this->default_val = default_val;
-        this->value = default_val;
-        this->min = min;
-        this->max = max;
+        uint64_t h = 0;
+        for(std::string_view s : a)
+            h = hash_step(h, s);
+        return h;
     }
-private:
-    inline string get_val_string(const Val &v, const char *fmt = nullptr) const
+    static bool used(std::string_view v) { return v.data(); }
+    static bool used(const OptionHelp &a) { return a.lines; }
+    // grow a hash table to keep it at most half full.
+    template<typename V, typename Hash>
+    static void grow(std::pmr::vector<V> &table, size_t num, Hash hash)
     {
-        if constexpr(is_same_v<T, bool>)
-            return get<bool>(v) ? "True" : "False";
-        else if constexpr(is_same_v<T, string>)
-            return get<string>(v);
-        else if(!fmt)
-            return to_string(get<T>(v));
-        else
+        if(num * 2 < table.size())
+            return;
+        std::pmr::vector<V> old(std::max<size_t>(64, table.size() * 2), V(), table.get_allocator());
+        old.swap(table);
+        const size_t mask = table.size() - 1;
+        for(const V &v : old)
         {
-            char *str = new char[256];
-            snprintf(str, 255, fmt, get<T>(v));
-            string rtn{str};
-            delete[] str;
-            return rtn;
+            if(!used(v))
+                continue;
+            size_t i = hash(v) & mask;
+            while(used(table[i]))
+                i = (i + 1) & mask;
+            table[i] = v;
         }
     }
+    std::string_view intern(std::string_view s)
+    {
+        if(s.empty())
+            return std::string_view();
+        bytes_requested += s.size();
+        grow(strs, num_strs, [](std::string_view v) { return PerfectHash<1>::Hash(v); });
+        const size_t mask = strs.size() - 1;
+        size_t i = PerfectHash<1>::Hash(s) & mask;
+        for(; strs[i].data(); i = (i + 1) & mask)
+            if(strs[i] == s)
+                return strs[i];
+        char *p = alloc(chars, s.size(), 1);
+        memcpy(p, s.data(), s.size());
+        num_strs++;
+        return strs[i] = std::string_view(p, s.size());
+    }
 public:
-    // return a string of value, fmt is a printf like format string
-    string GetValueString       (const char *fmt = nullptr) const { return get_val_string(value      , fmt); }
-    // return a string of default value, fmt is a printf like format string
-    string GetDefaultValueString(const char *fmt = nullptr) const { return get_val_string(default_val, fmt); }
-    // return a string of min value, fmt is a printf like format string
-    string GetMinValueString    (const char *fmt = nullptr) const { return get_val_string(min        , fmt); }
-    // return a string of max value, fmt is a printf like format string
-    string GetMaxValueString    (const char *fmt = nullptr) const { return get_val_string(max        , fmt); }
-#if(LOYOPTION_VERBOSE)
-    string GetStatusNameAndValueString() const
+    // blocks are allocated from upstream, or pmr::get_default_resource() if nullptr.
+    explicit StringPool(std::pmr::memory_resource *upstream = nullptr)
+        : upstream(upstream ? upstream : std::pmr::get_default_resource()),
+          blocks(this->upstream), strs(this->upstream), arrs(this->upstream) {}
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+    ~StringPool()
     {
-        string rtn = "[" + GetStatusString() + "] " + name;
-        if(!alt_name.empty())
-            rtn += ", " + alt_name;
-        if constexpr(is_same_v<T, string>)
-            rtn += " = \"" + GetValueString() + "\"";
-        else
-            rtn += " = " + GetValueString(base == 16 ? "0x%x" : nullptr);
-        return rtn;
+        for(auto &b : blocks)
+            upstream->deallocate(b.first, b.second, alignof(max_align_t));
     }
-#endif
-    void AppendHelpLinesTo(stringstream &ss) const
+    // the pool names and help lines of options are interned in by default, see MemoryScope,
+    // it lives for the whole process, never freeing strings interned, which is bounded by
+    // distinct names and help lines, use a pool of a MemoryScope for options of a limited lifetime.
+    static StringPool &Shared()
+    {
+        static StringPool pool;
+        return pool;
+    }
+    // return the interned copy of s, empty strings are not stored.
+    std::string_view Intern(std::string_view s)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return intern(s);
+    }
+    // return the interned array of lines [help.begin(), help.end()) and line, each interned,
+    // such as help lines of an option after push_back(line).
+    OptionHelp Append(OptionHelp help, std::string_view line)
     {
-        if constexpr(is_same_v<T, bool>)
+        std::lock_guard<std::mutex> lock(mtx);
+        std::string_view l = intern(line);
+        if(!l.data())
+            l = std::string_view("", 0);     // an empty line, interned as a static "".
+        const size_t num = help.size() + 1;
+        bytes_requested += num * sizeof(std::string_view);
+        grow(arrs, num_arrs, &hash_of);
+        const size_t mask = arrs.size() - 1;
+        size_t i = hash_step(hash_of(help), l) & mask;
+        for(; used(arrs[i]); i = (i + 1) & mask)
         {
-            ss << "    " << name;
-            if(!alt_name.empty())
-                ss << ", " << alt_name;
+            const OptionHelp &a = arrs[i];
+            if(a.size() == num && a[num - 1].data() == l.data() && a[num - 1].size() == l.size() &&
+                    std::equal(help.begin(), help.end(), a.begin(), [](std::string_view x, std::string_view y)
+                    { return x.data() == y.data() && x.size() == y.size(); }))
+                return a;
+        }
+        std::string_view *p;
+        if(help.end() == (const std::string_view *)arrays.cur && sizeof(std::string_view) <= (size_t)(arrays.end - arrays.cur))
+        {   // extend the last array in place, the shorter one stays valid.
+            p = (std::string_view *)help.begin();
+            arrays.cur += sizeof(std::string_view);
+            bytes_stored += sizeof(std::string_view);
         }
         else
         {
-            ss << "    " << name << " <value>";
-            if(!alt_name.empty())
-                ss << ", " << alt_name << " <value>";
-            ss << ", value is ";
-            ss << setbase(base) << showbase;
-            if constexpr(is_same_v<T, string>)
-                ss << "a string, default = \"" << get<string>(default_val) << "\"";
-            else if constexpr(is_same_v<T, int32_t>)
-            {
-                ss << "an integer literal";
-                ss << ( base ==  2 ? " in Binary"      :
-                        base ==  8 ? " in Octal"       : 
-                        base == 10 ? ""                : 
-                        base == 16 ? " in Hexadecimal" : " in Base-" + to_string(base));
-                ss << ", default = " << get<int32_t>(default_val);
-            }
-            else if constexpr(is_same_v<T, int64_t>)
-            {
-                ss << "an integer literal";
-                ss << ( base ==  2 ? " in Binary"      :
-                        base ==  8 ? " in Octal"       : 
-                        base == 10 ? ""                : 
-                        base == 16 ? " in Hexadecimal" : " in Base-" + to_string(base));
-                ss << ", default = " << get<int64_t>(default_val);
-            }
-            else if constexpr(is_same_v<T, uint32_t>)
-            {
-                ss << "an unsigned integer literal";
-                ss << ( base ==  2 ? " in Binary"      :
-                        base ==  8 ? " in Octal"       : 
-                        base == 10 ? ""                : 
-                        base == 16 ? " in Hexadecimal" : " in Base-" + to_string(base));
-                ss << ", default = " << get<uint32_t>(default_val);
-            }
-            else if constexpr(is_same_v<T, float>)
-                ss << "a floating point literal, default = " << get<float>(default_val);
-            else
-                ss << "a floating point literal, default = " << get<double>(default_val);
-            if(get<T>(min) != numeric_limits<T>::lowest() &&
-               get<T>(max) != numeric_limits<T>::max())
-            {
-                if constexpr(!is_same_v<T, string>)
-                    ss << ", range = [" << get<T>(min) << ", " << get<T>(max) << "]";
-            }
-            ss << setbase(0) << noshowbase;
-            ss << '.';
+            p = (std::string_view *)alloc(arrays, num * sizeof(std::string_view), alignof(std::string_view));
+            std::copy(help.begin(), help.end(), p);
         }
-        ss << endl;
-        if(HelpLines.size())
-            ss << "      : " << HelpLines[0] << endl;
-        for(size_t i = 1; i < HelpLines.size(); i++)
-            ss << "        " << HelpLines[i] << endl;
+        p[num - 1] = l;
+        num_arrs++;
+        return arrs[i] = OptionHelp(p, num);
+    }
+    // number of distinct strings and arrays stored.
+    size_t NumStrings() const { std::lock_guard<std::mutex> lock(mtx); return num_strs; }
+    size_t NumArrays() const { std::lock_guard<std::mutex> lock(mtx); return num_arrs; }
+    // bytes of all strings and arrays interned, what storing each of them would take.
+    size_t BytesRequested() const { std::lock_guard<std::mutex> lock(mtx); return bytes_requested; }
+    // bytes of distinct strings and arrays stored.
+    size_t BytesStored() const { std::lock_guard<std::mutex> lock(mtx); return bytes_stored; }
+    // bytes of blocks and hash tables allocated from upstream.
+    size_t BytesReserved() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        size_t n = strs.capacity() * sizeof(std::string_view) + arrs.capacity() * sizeof(OptionHelp) +
+                   blocks.capacity() * sizeof(blocks[0]);
+        for(auto &b : blocks)
+            n += b.second;
+        return n;
     }
 };
 
-class OptionParser
+// append line to help lines interned in pool.
+inline void OptionHelp::push_back(std::string_view line)
 {
-    using Arg = pair<bool, string>; // the bool: true if the arg string has been dealed;
-private:
-    vector<Arg> args;
-    string exec_name;
-    void get_exec_name()
+    StringPool *const p = pool;
+    *this = (p ? *p : StringPool::Shared()).Append(*this, line);
+    pool = p;
+}
+
+// MemoryCounter: a memory_resource passing allocations to upstream and counting their bytes,
+// for sizing an arena, not thread safe.
+class MemoryCounter : public std::pmr::memory_resource
+{
+    std::pmr::memory_resource *upstream;
+    size_t allocated = 0;   // total bytes allocated.
+    size_t in_use = 0;      // bytes allocated and not deallocated yet.
+    size_t peak = 0;        // max of in_use.
+    void *do_allocate(size_t bytes, size_t align) final
     {
-        int i;
-        for(i = args[0].second.size() - 1; i >= 0; i--)
-            if(args[0].second[i] == '/' || args[0].second[i] == '\\')
-                break;
-        exec_name = args[0].second.substr(i + 1);
+        void *p = upstream->allocate(bytes, align);
+        allocated += bytes;
+        in_use += bytes;
+        peak = std::max(peak, in_use);
+        return p;
+    }
+    void do_deallocate(void *p, size_t bytes, size_t align) final
+    {
+        upstream->deallocate(p, bytes, align);
+        in_use -= bytes;
     }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept final { return this == &other; }
+public:
+    // upstream is pmr::get_default_resource() if nullptr.
+    explicit MemoryCounter(std::pmr::memory_resource *upstream = nullptr)
+        : upstream(upstream ? upstream : std::pmr::get_default_resource()) {}
+    std::pmr::memory_resource *Upstream() const { return upstream; }
+    // total bytes allocated, what a monotonic arena would serve (without alignment padding).
+    size_t Allocated() const { return allocated; }
+    size_t InUse() const { return in_use; }
+    size_t Peak() const { return peak; }
+};
+
+// MemoryScope: while an instance is alive, options and parsers constructed in this thread
+// allocate their storage (string values, args and indexes) from mem, names and help lines
+// are interned in pool (or the one of the enclosing scope, at last StringPool::Shared()),
+// so that a whole parse can be served by an arena and released at once, e.g.:
+//   pmr::monotonic_buffer_resource arena(buf, sizeof(buf));
+//   {
+//       StringPool pool(&arena);        // optional, names and help lines in the arena too.
+//       MemoryScope scope(&arena, &pool);
+//       Option<pmr::string> opt_path("", "--path");
+//       OptionParser op(argc, argv);
+//       op.ParseAll(opts);
+//       ...
+//   }   // destruct options and parsers before the pool and the arena.
+// copies of options made by LiveOptions and OptionSnapshot use pmr::get_default_resource(),
+// and view names and help lines of the options copied.
+class MemoryScope
+{
+    static inline thread_local std::pmr::memory_resource *current = nullptr;
+    static inline thread_local StringPool *current_pool = nullptr;
+    std::pmr::memory_resource *prev;
+    StringPool *prev_pool;
 public:
-    // construct an instance by using argc and argv from main()
-    OptionParser(int argc, const char **argv)
+    //   * mem  : storage of options and parsers, pmr::get_default_resource() if nullptr.
+    //   * pool : names and help lines of options, the one of the enclosing scope if nullptr,
+    //            which must outlive the options.
+    explicit MemoryScope(std::pmr::memory_resource *mem, StringPool *pool = nullptr)
+        : prev(current), prev_pool(current_pool)
     {
-        char c[3] = {'-', ' ', '\0'};
-        int arglen = 0;
-        for(int i = 0; i < argc; i++)
-        {
-            arglen = strlen(argv[i]);
-            if(argv[i][0] == '-' && 3 <= arglen &&
-                    argv[i][1] != '-' && argv[i][1] != '.' &&
-                    !(argv[i][1] >= '0' && argv[i][1] <= '9'))
-            {   // single '-' started multi chars, starts with non digit 
-                for(int j = 1; j < arglen; j++)
-                {
-                    c[1] = argv[i][j];
-                    args.push_back(make_pair(false, string(c)));
-                }
-            }
-            else
-            {
-                args.push_back(make_pair(false, string(argv[i])));
-            }
-        }
-        args[0].first = true;   // exec name
-        get_exec_name();
-#if(LOYOPTION_VERBOSE)
-        cout << "[debug info] OptionParser.args:" << endl;
-        for(const Arg &a : args)
-        {
-            cout << "[debug info]     " << a.second << endl;
-        }
-#endif
+        current = mem;
+        if(pool)
+            current_pool = pool;
     }
-private:
-    void deal_integer(OptionBase &opt, const string &val_str) const
+    ~MemoryScope()
     {
-        char *s_end;
-        const char *c_str = val_str.c_str();
-        int64_t val = strtoll(c_str, &s_end, opt.base);
-        if(s_end < c_str + strlen(c_str))
-            opt.status = OptionBase::ValueInvalid;
-        else
-            opt.update_numeric_value_n_status(val);
+        current = prev;
+        current_pool = prev_pool;
     }
-    void deal_floating(OptionBase &opt, const string &val_str) const
+    MemoryScope(const MemoryScope &) = delete;
+    MemoryScope &operator=(const MemoryScope &) = delete;
+    // the memory_resource of the innermost scope of this thread, or pmr::get_default_resource().
+    static std::pmr::memory_resource *Current() { return current ? current : std::pmr::get_default_resource(); }
+    // the StringPool of the innermost scope with one of this thread, or StringPool::Shared().
+    static StringPool &CurrentPool() { return current_pool ? *current_pool : StringPool::Shared(); }
+};
+
+#if(LOYOPTION_THREADS)
+// ParallelExecutor: a caller's thread pool running parallel parsing of long list values,
+// see Option<vector<E>>::SetParallel(), it calls task(arg) up to num times concurrently
+// (at least once, on any threads, including the calling one), returns after all calls returned.
+// each call of task takes chunks of the value until none left, so fewer calls are fine.
+using ParallelExecutor = void (*)(void (*task)(void *), void *arg, unsigned num, void *ctx);
+
+// WorkerPool: threads started on the 1st use and reused by all later runs, the default executor
+// of parallel parsing of long list values, Shared() by all options, one run at a time.
+class WorkerPool
+{
+    std::mutex mtx;
+    std::condition_variable start_cv, done_cv;
+    std::vector<std::thread> threads;
+    const unsigned max_threads;
+    void (*task)(void *) = nullptr;
+    void *arg = nullptr;
+    unsigned pending = 0;       // calls of task of the current run not started by a thread yet.
+    unsigned running = 0;       // calls of task started and not returned yet.
+    bool busy = false;          // a run is in progress.
+    bool stop = false;
+    void loop()
     {
-        char *s_end;
-        const char *c_str = val_str.c_str();
-        double val = strtod(c_str, &s_end);
-        if(s_end < c_str + strlen(c_str) || isnan(val))
-            opt.status = OptionBase::ValueInvalid;
-        else
-            opt.update_numeric_value_n_status(val);
+        std::unique_lock<std::mutex> lock(mtx);
+        for(;;)
+        {
+            start_cv.wait(lock, [this] { return stop || pending; });
+            if(stop)
+                return;
+            pending--;
+            running++;
+            void (*const t)(void *) = task;
+            void *const a = arg;
+            lock.unlock();
+            t(a);
+            lock.lock();
+            if(--running == 0)
+                done_cv.notify_all();
+        }
     }
 public:
-    // return number of args (including exe name)
-    size_t NumArgs() const { return args.size(); }
-    // return ref of the executable name without path
-    const string &ExecName() const { return exec_name; }
-    // Parse args for the opt
-    //   * opt    : an instance of Option to be updated.
-    //   * return : status of the opt.
-    OptionBase::Status Parse(OptionBase &opt)
+    // a pool of up to max_threads threads, not started until used.
+    explicit WorkerPool(unsigned max_threads) : max_threads(max_threads) {}
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    ~WorkerPool()
     {
-        const size_t type = opt.value.index();
-        size_t i;
-        for(i = 0; i < args.size(); i++)
         {
-            Arg &a = args[i];
-            if(opt.NameMatch(a.second))
-            {
-                a.first = true;
-                if(0 == type) // constexpr(is_same_v<T, bool>)
-                {   // bool (no value)
-                    opt.update_numeric_value_n_status(true);
-                    break;
-                }
-                else
-                {   // string and numeric
-                    if(i + 1 < args.size())
-                    {
-                        Arg &v = args[i + 1];
-                        v.first = true;
-                        if(1 == type)
-                        {
-                            opt.value = v.second;
-                            opt.status = OptionBase::Parsed;
-                            break;
-                        }
-                        else if(2 <= type && type <= 4)
-                        {
-                            deal_integer(opt, v.second);
-                            break;
-                        }
-                        else
-                        {
-                            deal_floating(opt, v.second);
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        opt.status = OptionBase::ValueNotFound;
-                        break;
-                    }
-                }
-            }
+            std::lock_guard<std::mutex> lock(mtx);
+            stop = true;
         }
-        if(i == args.size())
+        start_cv.notify_all();
+        for(std::thread &t : threads)
+            t.join();
+    }
+    // the pool of thread::hardware_concurrency() - 1 threads, joined at exit.
+    static WorkerPool &Shared()
+    {
+        static WorkerPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+        return pool;
+    }
+    // call task(arg) on the calling thread and up to num - 1 threads of the pool concurrently,
+    // return after all calls returned,
+    // task(arg) is called once on the calling thread only if the pool is busy with another run.
+    void Run(void (*task)(void *), void *arg, unsigned num)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        const unsigned helpers = num > 1 ? std::min(num - 1, max_threads) : 0;
+        if(busy || helpers == 0)
         {
-            opt.status = OptionBase::NotFound;
+            lock.unlock();
+            return task(arg);
         }
-#if(LOYOPTION_VERBOSE)
-        cout << "[debug info] OptionParser::Parse() : " << opt.GetStatusNameAndValueString() << endl;
-#endif
-        return opt.status;
+        busy = true;
+        while(threads.size() < helpers)
+            threads.emplace_back([this] { loop(); });
+        this->task = task;
+        this->arg = arg;
+        pending = helpers;
+        lock.unlock();
+        start_cv.notify_all();
+        task(arg);
+        lock.lock();
+        pending = 0;    // all chunks are taken once task returned, calls not started are needless.
+        done_cv.wait(lock, [this] { return running == 0; });
+        busy = false;
     }
-    // FirstUnparedArg returns the 1st unparsed arg.
-    // after parsed for all options, this will be
-    // the 1st unrecognised option or duplicated option.
-    const string &FirstUnparsedArg() const
+    // a ParallelExecutor of Run() of the pool ctx, or of Shared() if ctx is nullptr.
+    static void Execute(void (*task)(void *), void *arg, unsigned num, void *ctx)
     {
-        static string empty;
-        for(const Arg &a : args)
-            if(!a.first)
-                return a.second;
-        return empty;
+        (ctx ? *static_cast<WorkerPool *>(ctx) : Shared()).Run(task, arg, num);
+    }
+};
+#endif
+
+class OptionBase
+{
+    friend class OptionParser;
+    template<typename... Opts> friend class OptionSet;
+    friend class LiveOptions;
+    friend class OptionSnapshot;
+    friend class OptionBlob;
+    friend class OptionStream;
+public:
+    enum Type : uint8_t   // value type of option.
+    {
+        Bool, String, Int32, Uint32, Int64, Float, Double,
+        Enum    // a choice option, such as Option<E> with a ChoiceSet<E, N>.
+    };
+    enum Status : uint32_t
+    {
+        NotParsed     = 0, // has not been tried parsing from args.
+        NotFound         , // has been tried parsing from args, but not found.
+        NameAmbiguous    , // has been tried parsing from args, not found, but an arg is a prefix of its and others' names,
+                           // only by OptionParser::ParseAll() with SetPrefixMatch(true).
+        ValueInvalid     , // has been tried parsing from args, but followed with invalid value.
+        ValueNotFound    , // has been tried parsing from args, but without following value.
+        ValueOverflow    , // has been tried parsing from args, but value is out of range of the value type (and not clamped).
+        ClampedMax       , // has been parsed from args, and updated value with max since overflow.
+        ClampedMin       , // has been parsed from args, and updated value with min since underflow.
+        Parsed             // has been parsed from args, and updated value.
+    };
+    // is option name exist in args?
+    inline bool IsNameExist()
+    {
+        return status != NotParsed && status != NotFound && status != NameAmbiguous;
+    }
+    enum Source : uint8_t   // where value of option is from.
+    {
+        FromDefault = 0, // not updated, or not found.
+        FromArgs       , // from args of an OptionParser.
+        FromEnv        , // from an environment variable, see OptionParser::LoadEnv().
+        FromFile         // from a config file, see OptionParser::LoadConfig().
+    };
+    enum Unit : uint8_t     // unit of an integer option's value, see SetUnit().
+    {
+        NoUnit = 0,     // a plain integer literal.
+        Bytes     ,     // with an optional byte multiplier suffix, such as "64K", "2GiB" or "10MB".
+        Nanoseconds,    // time in ns, with an optional time unit suffix, such as "150ms" or "5m".
+        Microseconds,   // time in us, with an optional time unit suffix.
+        Milliseconds,   // time in ms, with an optional time unit suffix.
+        Seconds   ,     // time in s, with an optional time unit suffix.
+        Minutes   ,     // time in minutes, with an optional time unit suffix.
+        Hours           // time in hours, with an optional time unit suffix.
+    };
+    enum Field : uint8_t    // which value of an option to format, see FormatValue().
+    {
+        FieldValue, FieldDefault, FieldMin, FieldMax
+    };
+    // is option value updated ?
+    // (option name exist and option value is in range or clamped into range)
+    inline bool IsValueUpdated()
+    {
+        return status == Parsed || status == ClampedMax || status == ClampedMin;
+    }
+
+protected:
+    inline static const std::string sts_str[10]    // human readable status string.
+    {
+        "Opt Not Parsed", "Opt Not Found ", "Name Ambiguous",
+        "Value Invalid ", "Value NotFound",
+        "Value Overflow",
+        "Clamped To Max", "Clamped To Min",
+        "Parsed Success", ""
+    };
+    Status status = NotParsed;                  // status of this option.
+    const Type type;                            // value type of this option, or of each element of a list option.
+    const bool list;                            // is a list option, such as Option<vector<int32_t>>.
+    Source source = FromDefault;                // where name and value of this option are found.
+    std::string_view name;                      // name of option, such as "-a", "--str"
+    std::string_view alt_name;                  // alternative name, such as "-b", "--str2"
+    std::string_view matched_name;              // last matched name, name or alt_name
+    int base = 10;                              // base of numeric option's value, 2-36, normally 2, 8, 10 and 16.
+    Unit unit = NoUnit;                         // unit of integer option's value.
+    size_t live_slot = SIZE_MAX;                // index in snapshots of the LiveOptions it registered to.
+    uint32_t help_gen = 0;                      // bumped by setters changing help text, such as SetUnit().
+    struct HelpCache
+    {
+        std::string text;                     // rendered help text, see HelpText().
+        OptionHelp lines;                     // help lines rendered in text.
+        uint32_t gen;                         // help_gen rendered in text.
+    };
+    mutable std::unique_ptr<HelpCache> help_cache; // allocated when HelpText() is called.
+    // constexpr, so that an OptionBase of a StaticOption can be constant initialized.
+    constexpr OptionBase(Type type, bool list = false) : type(type), list(list) {}
+    // copy all but the help cache, names still view ones of o.
+    OptionBase(const OptionBase &o) : status(o.status), type(o.type), list(o.list),
+            source(o.source), name(o.name), alt_name(o.alt_name), matched_name(o.matched_name),
+            base(o.base), unit(o.unit), live_slot(o.live_slot) {}
+    OptionBase &operator=(const OptionBase &) = delete;
+    static constexpr int clamp_base(int base) { return base < 2 ? 2 : base > 36 ? 36 : base; }
+    template<typename T>
+    static constexpr bool is_string_v = std::is_same_v<T, std::string> || std::is_same_v<T, std::pmr::string> ||
+                                        std::is_same_v<T, std::string_view>;
+    template<typename T>
+    static constexpr Type type_of =
+            std::is_same_v<T, bool>     ? Bool   : is_string_v<T>        ? String :
+            std::is_same_v<T, int32_t>  ? Int32  : std::is_same_v<T, uint32_t> ? Uint32 :
+            std::is_same_v<T, int64_t>  ? Int64  : std::is_same_v<T, float>   ? Float  :
+            std::is_enum_v<T>           ? Enum   : Double;
+    template<typename U, typename T>
+    inline T clamp(U val, T min, T max)
+    {
+        status = val < min ? ClampedMin : val > max ? ClampedMax : Parsed;
+        return (T)(val < min ? min : val > max ? max : val);
+    }
+    enum NumericResult { NumParsed, NumInvalid, NumOverflow, NumNegative };
+    // is a decimal, or hex (without "0x") floating point literal in [p, end) less than 1 in magnitude,
+    // telling underflow from overflow of a literal out of range.
+    static bool is_tiny_literal(const char *p, const char *end, bool hex)
+    {
+        const auto is_digit = [hex](char c)
+        {
+            return (c >= '0' && c <= '9') || (hex && (c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+        };
+        int64_t e = 0;  // exponent of the 1st non zero digit, in digits.
+        bool nonzero = false;
+        for(; p < end && is_digit(*p); p++)
+        {
+            nonzero = nonzero || *p != '0';
+            e += nonzero;
+        }
+        e -= nonzero;
+        if(p < end && *p == '.')
+        {
+            for(p++; p < end && is_digit(*p); p++)
+            {
+                if(!nonzero)
+                {
+                    e--;
+                    nonzero = *p != '0';
+                }
+            }
+        }
+        int64_t exp = 0;
+        if(p < end && (*p | 0x20) == (hex ? 'p' : 'e'))
+        {
+            const bool neg = ++p < end && *p == '-';
+            p += p < end && (*p == '+' || *p == '-');
+            for(; p < end && *p >= '0' && *p <= '9'; p++)
+                exp = exp < 1000000000 ? exp * 10 + (*p - '0') : exp;
+            exp = neg ? -exp : exp;
+        }
+        return (hex ? e * 4 : e) + exp < 0;
+    }
+    // number of leading white spaces of str, skipped before a numeric literal as by strtoll().
+    static size_t leading_spaces(std::string_view str)
+    {
+        size_t i = 0;
+        while(i < str.size() && (str[i] == ' ' || (str[i] >= '\t' && str[i] <= '\r')))
+            i++;
+        return i;
+    }
+    // a literal str out of range of T is clamped to the range [min, max] of an option, when it's
+    // narrower than T on that side, same as a value in range of T but out of [min, max].
+    //   * return : ClampedMin or ClampedMax, or ValueOverflow with val unchanged if the range is
+    //              not narrower than T on that side.
+    template<typename T>
+    static Status clamp_overflow(std::string_view str, const T &min, const T &max, T &val)
+    {
+        const size_t i = leading_spaces(str);
+        const bool neg = i < str.size() && str[i] == '-';
+        if(neg ? !(min > std::numeric_limits<T>::lowest()) : !(max < std::numeric_limits<T>::max()))
+            return ValueOverflow;
+        val = neg ? min : max;
+        return neg ? ClampedMin : ClampedMax;
+    }
+    // parse a numeric literal straight into val, locale independent.
+    //   * str    : leading white spaces and an optional sign (as strtoll() and strtod()),
+    //              then an integer literal in base (optionally prefixed with "0x" when base is 16),
+    //              or a decimal or "0x" prefixed hex floating point literal.
+    //   * return : NumNegative if str is a negative literal for unsigned T,
+    //              a floating point literal too small for T is parsed as 0 (with sign), like strtod().
+    template<typename T>
+    static NumericResult parse_numeric(std::string_view str, int base, T &val)
+    {
+        const char *p = str.data() + leading_spaces(str), *end = str.data() + str.size();
+        bool neg = false;
+        if(p < end && (*p == '+' || *p == '-'))
+            neg = *p++ == '-';
+        if(p == end || *p == '+' || *p == '-')
+            return NumInvalid;
+        const bool hex = end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X');
+        if constexpr(std::is_integral_v<T>)
+        {
+            using U = std::make_unsigned_t<T>;
+            U mag;
+            if(hex && base == 16)
+                p += 2;
+            std::from_chars_result r = std::from_chars(p, end, mag, base);
+            if(r.ptr != end || r.ec == std::errc::invalid_argument)
+                return NumInvalid;
+            if(r.ec == std::errc::result_out_of_range)
+                return NumOverflow;
+            if constexpr(std::is_unsigned_v<T>)
+            {
+                if(neg && mag != 0)
+                    return NumNegative;
+                val = mag;
+            }
+            else
+            {
+                if(mag > (U)std::numeric_limits<T>::max() + (neg ? 1 : 0))
+                    return NumOverflow;
+                val = neg ? (T)(0 - mag) : (T)mag;
+            }
+        }
+        else
+        {
+#if(LOYOPTION_FROM_CHARS_FLOAT)
+            if(hex)
+                p += 2;
+            std::from_chars_result r = std::from_chars(p, end, val, hex ? std::chars_format::hex : std::chars_format::general);
+            if(r.ptr != end || r.ec == std::errc::invalid_argument)
+                return NumInvalid;
+            if(r.ec == std::errc::result_out_of_range)
+            {
+                if(!is_tiny_literal(p, end, hex))
+                    return NumOverflow;
+                val = 0;    // underflow, denormals are parsed by from_chars().
+            }
+#else
+            const std::string s(p, end);  // strtod() needs a '\0' terminated string
+            char *s_end;
+            errno = 0;
+            double d = strtod(s.c_str(), &s_end);
+            if(s_end != s.c_str() + s.size())
+                return NumInvalid;
+            if((errno == ERANGE && fabs(d) >= 1) || (std::isfinite(d) && !std::isfinite((T)d)))
+                return NumOverflow;     // underflow is 0 or a denormal.
+            val = (T)d;
+#endif
+            if(std::isnan(val))
+                return NumInvalid;
+            if(neg)
+                val = -val;
+        }
+        return NumParsed;
+    }
+    // a suffix of unit, and it's multiplier in bytes or ns,
+    // suffixes of a multiplier are adjacent, both parsing and help text are from the tables.
+    struct UnitSuffix
+    {
+        std::string_view str;
+        uint64_t mult;
+    };
+    static constexpr UnitSuffix byte_sfxs[] =
+    {
+        {"B",  1},
+        {"K",  1ull << 10}, {"Ki", 1ull << 10}, {"KiB", 1ull << 10}, {"KB", 1000ull}, {"kB", 1000ull},
+        {"M",  1ull << 20}, {"Mi", 1ull << 20}, {"MiB", 1ull << 20}, {"MB", 1000000ull},
+        {"G",  1ull << 30}, {"Gi", 1ull << 30}, {"GiB", 1ull << 30}, {"GB", 1000000000ull},
+        {"T",  1ull << 40}, {"Ti", 1ull << 40}, {"TiB", 1ull << 40}, {"TB", 1000000000000ull},
+        {"P",  1ull << 50}, {"Pi", 1ull << 50}, {"PiB", 1ull << 50}, {"PB", 1000000000000000ull},
+        {"E",  1ull << 60}, {"Ei", 1ull << 60}, {"EiB", 1ull << 60}, {"EB", 1000000000000000000ull}
+    };
+    static constexpr UnitSuffix time_sfxs[] =
+    {
+        {"ns", 1}, {"us", 1000ull}, {"ms", 1000000ull}, {"s", 1000000000ull},
+        {"m", 60000000000ull}, {"min", 60000000000ull}, {"h", 3600000000000ull}, {"d", 86400000000000ull}
+    };
+    // return multiplier of suffix sfx of unit, in bytes or ns, 0 if sfx is not a suffix of unit.
+    static uint64_t unit_multiplier(Unit unit, std::string_view sfx)
+    {
+        if(unit == Bytes)
+        {
+            for(const UnitSuffix &s : byte_sfxs)
+                if(s.str == sfx)
+                    return s.mult;
+        }
+        else if(unit != NoUnit)
+        {
+            for(const UnitSuffix &s : time_sfxs)
+                if(s.str == sfx)
+                    return s.mult;
+        }
+        return 0;
+    }
+    // return the value of 1 unit, in bytes or ns.
+    static constexpr uint64_t unit_size(Unit unit)
+    {
+        constexpr uint64_t sizes[] = { 1, 1, 1, 1000ull, 1000000ull, 1000000000ull, 60000000000ull, 3600000000000ull };
+        return sizes[unit];
+    }
+    // return size of the integer literal in base at the start of str, with optional sign and "0x",
+    // the longest run of digits in base, so that a suffix follows all digits, such as "0x1B".
+    static size_t integer_size(std::string_view str, int base)
+    {
+        size_t i = leading_spaces(str);
+        if(i < str.size() && (str[i] == '+' || str[i] == '-'))
+            i++;
+        if(base == 16 && str.size() - i > 2 && str[i] == '0' && (str[i + 1] == 'x' || str[i + 1] == 'X'))
+            i += 2;
+        for(; i < str.size(); i++)
+        {
+            const char c = str[i];
+            const int d = c >= '0' && c <= '9' ? c - '0' :
+                          (c | 0x20) >= 'a' && (c | 0x20) <= 'z' ? (c | 0x20) - 'a' + 10 : 36;
+            if(d >= base)
+                break;
+        }
+        return i;
+    }
+    // parse an integer literal with an optional suffix of unit, such as "64K" or "150ms",
+    // into val in unit, without allocating, the suffix follows all digits in base,
+    // optionally separated by '_', such as "0x1B" in base 16 is 27, and "0x1_B" is 1 byte.
+    //   * return : NumOverflow if the scaled value is out of range of T,
+    //              NumInvalid if the value can not be exactly represented in unit, such as "1500us"
+    //              in Milliseconds, or the number part is invalid.
+    template<typename T>
+    static NumericResult parse_unit(std::string_view str, int base, Unit unit, T &val)
+    {
+        using W = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+        const uint64_t size = unit_size(unit);
+        uint64_t mult = size;       // no suffix
+        size_t num_len = integer_size(str, base);
+        if(num_len < str.size())
+        {
+            const size_t sfx = num_len + (str[num_len] == '_' && num_len + 1 < str.size());
+            const uint64_t m = unit_multiplier(unit, str.substr(sfx));
+            if(m)
+                mult = m;
+            else
+                num_len = str.size();   // not a suffix, invalid as a number.
+        }
+        W num;
+        const NumericResult res = parse_numeric(str.substr(0, num_len), base, num);
+        if(res != NumParsed)
+            return res;
+        W scaled;
+        if(mult >= size)
+        {
+            const W f = (W)(mult / size);
+            if(num > std::numeric_limits<W>::max() / f || num < std::numeric_limits<W>::lowest() / f)
+                return NumOverflow;
+            scaled = num * f;
+        }
+        else
+        {
+            const W d = (W)(size / mult);
+            if(num % d != 0)
+                return NumInvalid;
+            scaled = num / d;
+        }
+        if(scaled > std::numeric_limits<T>::max() || scaled < std::numeric_limits<T>::lowest())
+            return NumOverflow;
+        val = (T)scaled;
+        return NumParsed;
+    }
+    // update value and status from str, the value string following the name in args,
+    // for a bool option, str is nullptr data for a name in args, or a value of an environment
+    // variable or a config file, see parse_bool().
+    virtual void deal_value(std::string_view str) = 0;
+    // restore value to default value, and status to NotParsed.
+    virtual void reset() = 0;
+    // return a copy of this option for a snapshot of LiveOptions.
+    virtual std::unique_ptr<OptionBase> clone() const = 0;
+    // set names interned in MemoryScope::CurrentPool(), shared by options of the same names.
+    void set_names(std::string_view name, std::string_view alt_name)
+    {
+        StringPool &pool = MemoryScope::CurrentPool();
+        this->name = pool.Intern(name);
+        this->alt_name = pool.Intern(alt_name);
+    }
+    // help lines of this option, an array never changed once viewed, such as an interned one.
+    virtual OptionHelp help_lines() const = 0;
+    // write field by format_scalar(), see FormatValue().
+    virtual char *format_value(char *first, char *last, Field field, int base, int precision) const = 0;
+    // max chars written by format_value().
+    virtual size_t format_size(Field field, int precision) const = 0;
+    // names allowed as value, such as names of a ChoiceSet, for shell completion.
+    virtual size_t num_value_names() const { return 0; }
+    virtual std::string_view value_name(size_t i) const { (void)i; return std::string_view(); }
+
+    // ---- value parsing and formatting of scalar T, shared by Option<T> and StaticOption<T> ----
+    // parse a bool value of an environment variable or a config file, case insensitive,
+    // "1", "true", "yes", "on" for true, "0", "false", "no", "off" or empty for false.
+    //   * return : false if str is none of them.
+    static bool parse_bool(std::string_view str, bool &val)
+    {
+        static constexpr std::string_view names[] = {"0", "false", "no", "off", "1", "true", "yes", "on"};
+        for(size_t k = 0; k < 8; k++)
+        {
+            const std::string_view n = names[k];
+            bool same = str.size() == n.size();
+            for(size_t j = 0; same && j < n.size(); j++)
+                same = (str[j] >= 'A' && str[j] <= 'Z' ? str[j] - 'A' + 'a' : str[j]) == n[j];
+            if(same)
+            {
+                val = k >= 4;
+                return true;
+            }
+        }
+        val = false;
+        return str.empty();
+    }
+    template<typename T>
+    void deal_scalar(std::string_view str, T &value, const T &min, const T &max)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+        {   // a name in args is true, a value is only given by an environment variable or a config file.
+            bool val = true;
+            if(str.data() && !parse_bool(str, val))
+            {
+                status = ValueInvalid;
+                return;
+            }
+            value = val;
+            status = Parsed;
+        }
+        else if constexpr(is_string_v<T>)
+        {
+            value = str;
+            status = Parsed;
+        }
+        else
+        {
+            T val;
+            NumericResult res;
+            if constexpr(std::is_integral_v<T>)
+                res = unit != NoUnit ? parse_unit(str, base, unit, val) : parse_numeric(str, base, val);
+            else
+                res = parse_numeric(str, base, val);
+            switch(res)
+            {
+            case NumParsed   : value = clamp(val, min, max);
+                break;
+            case NumNegative : value = min; status = ClampedMin;
+                break;
+            case NumOverflow : status = clamp_overflow(str, min, max, value);
+                break;
+            default          : status = ValueInvalid;
+                break;
+            }
+        }
+    }
+    template<typename T>
+    static std::string scalar_string(const T &v, const char *fmt)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+            return v ? "True" : "False";
+        else if constexpr(is_string_v<T>)
+            return std::string(v);
+        else if(!fmt)
+            return std::to_string(v);
+        else
+        {
+            char str[256];
+            snprintf(str, sizeof(str), fmt, v);
+            return str;
+        }
+    }
+    // max chars written by format_scalar() of v.
+    template<typename T>
+    static size_t scalar_format_size(const T &v, int precision)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+            return 5;
+        else if constexpr(is_string_v<T>)
+            return v.size();
+        else if constexpr(std::is_integral_v<T>)
+            return 1 + 8 * sizeof(T);   // sign and binary digits.
+        else
+            return precision < 0 ? 32 : 32 + (size_t)precision;
+    }
+    // write v into [first, last) by to_chars(), integers in base, floating points in shortest
+    // round trip form, or "%g" like with precision significant digits if precision >= 0.
+    //   * return : past the end of chars written, nullptr if they don't fit.
+    template<typename T>
+    static char *format_scalar(char *first, char *last, const T &v, int base, int precision)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+            return format_scalar(first, last, std::string_view(v ? "True" : "False"), base, precision);
+        else if constexpr(is_string_v<T>)
+        {
+            const std::string_view str = v;
+            if(str.size() > (size_t)(last - first))
+                return nullptr;
+            return std::copy(str.begin(), str.end(), first);
+        }
+        else if constexpr(std::is_integral_v<T>)
+        {
+            const std::to_chars_result r = std::to_chars(first, last, v, base);
+            return r.ec == std::errc() ? r.ptr : nullptr;
+        }
+        else
+        {
+#if(LOYOPTION_FROM_CHARS_FLOAT)
+            const std::to_chars_result r = precision < 0 ? std::to_chars(first, last, v) :
+                                      std::to_chars(first, last, v, std::chars_format::general, precision);
+            return r.ec == std::errc() ? r.ptr : nullptr;
+#else
+            const int n = snprintf(first, last - first, "%.*g",
+                    precision < 0 ? std::numeric_limits<T>::max_digits10 : precision, (double)v);
+            return n >= 0 && n < last - first ? first + n : nullptr;
+#endif
+        }
+    }
+
+    // ---- help rendering, by appending to a string, without iostream ----
+    // max chars of a numeric literal rendered by append_literal().
+    static constexpr size_t max_literal_size = 32;
+    // append v as by ostream with setbase(base) and showbase, or printf's "%g" for floating point.
+    template<typename T>
+    static void append_literal(std::string &buf, T v, int base)
+    {
+        char s[max_literal_size], *p = s, *e = s + sizeof(s);
+        if constexpr(std::is_integral_v<T>)
+        {
+            if(base == 8 || base == 16)
+            {   // printed as unsigned, with prefix "0" or "0x" for non zero value.
+                if(v != 0)
+                    *p++ = '0';
+                if(v != 0 && base == 16)
+                    *p++ = 'x';
+                p = std::to_chars(p, e, (std::make_unsigned_t<T>)v, base).ptr;
+            }
+            else
+                p = std::to_chars(p, e, v).ptr;
+        }
+        else
+        {
+#if(LOYOPTION_FROM_CHARS_FLOAT)
+            p = std::to_chars(p, e, v, std::chars_format::general, 6).ptr;
+#else
+            p += snprintf(p, sizeof(s), "%g", (double)v);
+#endif
+        }
+        buf.append(s, p);
+    }
+    // append "    name<placeholder>, alt_name<placeholder>".
+    void append_help_names(std::string &buf, std::string_view placeholder) const
+    {
+        buf.append("    ").append(name).append(placeholder);
+        if(!alt_name.empty())
+            buf.append(", ").append(alt_name).append(placeholder);
+    }
+    // append " in Hexadecimal" or similar for an integer option.
+    void append_help_base(std::string &buf) const
+    {
+        switch(base)
+        {
+        case  2: buf.append(" in Binary");      break;
+        case  8: buf.append(" in Octal");       break;
+        case 10:                                break;
+        case 16: buf.append(" in Hexadecimal"); break;
+        default: append_literal(buf.append(" in Base-"), base, 10); break;
+        }
+    }
+    // append " in bytes, with suffix ..." or similar for an integer option with a unit.
+    void append_help_unit(std::string &buf) const
+    {
+        static constexpr const char *units[] = { "", "bytes", "ns", "us", "ms", "s", "minutes", "hours" };
+        if(unit == NoUnit)
+            return;
+        buf.append(" in ").append(units[unit]).append(", with an optional suffix ");
+        // suffixes in order of the table, those of the same multiplier joined by '/', such as "K/Ki/KiB",
+        // only those of multipliers of powers of 2, or only the others, unless all.
+        auto append_sfxs = [&buf](const auto &sfxs, bool all, bool pow2, const char *last_sep)
+        {
+            const uint64_t last_mult = std::end(sfxs)[-1].mult;
+            uint64_t prev = 0;
+            for(const UnitSuffix &sfx : sfxs)
+            {
+                if(!all && ((sfx.mult & (sfx.mult - 1)) == 0) != pow2)
+                    continue;
+                if(prev)
+                    buf.append(sfx.mult == prev ? "/" : sfx.mult == last_mult ? last_sep : ", ");
+                buf.append(sfx.str);
+                prev = sfx.mult;
+            }
+        };
+        if(unit == Bytes)
+        {
+            append_sfxs(byte_sfxs, false, true, ", ");
+            buf.append(" (1024 based) or ");
+            append_sfxs(byte_sfxs, false, false, ", ");
+        }
+        else
+            append_sfxs(time_sfxs, true, false, " or ");
+    }
+    // append the formatted help lines.
+    void append_help_lines(std::string &buf) const
+    {
+        const OptionHelp lines = help_lines();
+        for(size_t i = 0; i < lines.size(); i++)
+            buf.append(i ? "        " : "      : ").append(lines[i]).append(1, '\n');
+    }
+    // size of the parts of help text not depending on value type, for buffer reserving.
+    size_t help_base_size() const
+    {
+        size_t size = 2 * (name.size() + alt_name.size()) + 160;
+        for(std::string_view line : help_lines())
+            size += line.size() + 9;
+        return size;
+    }
+    template<typename T>
+    size_t scalar_help_size(const T &default_val) const
+    {
+        size_t size = help_base_size() + 3 * max_literal_size;
+        if constexpr(is_string_v<T>)
+            size += default_val.size();
+        return size;
+    }
+    template<typename T>
+    void render_scalar_help(std::string &buf, const T &default_val, const T &min, const T &max) const
+    {
+        if constexpr(std::is_same_v<T, bool>)
+            append_help_names(buf, "");
+        else
+        {
+            append_help_names(buf, " <value>");
+            buf.append(", value is ");
+            if constexpr(is_string_v<T>)
+                buf.append("a string, default = \"").append(default_val).append(1, '"');
+            else
+            {
+                if constexpr(std::is_integral_v<T>)
+                {
+                    buf.append(std::is_unsigned_v<T> ? "an unsigned integer literal" : "an integer literal");
+                    append_help_base(buf);
+                    append_help_unit(buf);
+                }
+                else
+                    buf.append("a floating point literal");
+                append_literal(buf.append(", default = "), default_val, base);
+                if(min != std::numeric_limits<T>::lowest() &&
+                   max != std::numeric_limits<T>::max())
+                {
+                    append_literal(buf.append(", range = ["), min, base);
+                    append_literal(buf.append(", "), max, base);
+                    buf.append(1, ']');
+                }
+            }
+            buf.append(1, '.');
+        }
+        buf.append(1, '\n');
+        append_help_lines(buf);
+    }
+    // append all help text of this option to buf.
+    virtual void render_help(std::string &buf) const = 0;
+    // upper bound of size of help text rendered by render_help().
+    virtual size_t help_size() const = 0;
+
+    // ---- raw bytes of value for OptionBlob, in host byte order ----
+    template<typename T>
+    static void save_bytes(std::string &blob, const T &v)
+    {
+        if constexpr(is_string_v<T>)
+            blob.append(v);
+        else if constexpr(std::is_arithmetic_v<T>)
+            blob.append((const char *)&v, sizeof(T));
+        else if constexpr(std::is_enum_v<T>)
+            save_bytes(blob, (int64_t)v);
+        else
+            blob.append((const char *)v.data(), v.size() * sizeof(typename T::value_type));
+    }
+    // bytes has been checked by OptionBlob::Load() to be of the size of T or its elements.
+    template<typename T>
+    static void load_bytes(std::string_view bytes, T &v)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+            v = bytes[0] != 0;
+        else if constexpr(is_string_v<T>)
+            v = bytes;
+        else if constexpr(std::is_arithmetic_v<T>)
+            memcpy(&v, bytes.data(), sizeof(T));
+        else if constexpr(std::is_enum_v<T>)
+        {
+            int64_t i;
+            load_bytes(bytes, i);
+            v = (T)i;
+        }
+        else
+        {
+            v.resize(bytes.size() / sizeof(typename T::value_type));
+            if(!v.empty())  // data() of an empty vector may be nullptr.
+                memcpy(v.data(), bytes.data(), v.size() * sizeof(typename T::value_type));
+        }
+    }
+    // append raw bytes of value to blob.
+    virtual void save_value(std::string &blob) const = 0;
+    // update value from raw bytes saved by save_value().
+    virtual void load_value(std::string_view bytes) = 0;
+public:
+    virtual ~OptionBase() = default;
+    bool NameMatch(std::string_view name)
+    {
+        if(this->name == name)
+        {
+            this->matched_name = this->name;
+            return true;
+        }
+        else if(!this->alt_name.empty() && this->alt_name == name)
+        {
+            this->matched_name = this->alt_name;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }    
+    // restore value to default value and status to NotParsed, for parsing another args,
+    // keeps capacity of a string or list value.
+    void Reset() { reset(); }
+    Status GetStatus() const { return status; }
+    Source GetSource() const { return source; }
+    Type GetType() const { return type; }
+    bool IsList() const { return list; }
+    std::string_view GetName() const { return name; }
+    std::string_view GetAltName() const { return alt_name; }
+    std::string_view GetLastMatchedName() const { return matched_name; }
+    const std::string &GetStatusString() const { return sts_str[(uint32_t)status]; }
+    int Base() const { return base; }
+    Unit GetUnit() const { return unit; }
+    // set unit of an integer (or integer list) option's value, such as Bytes for "64K" as 65536,
+    // or Milliseconds for "5s" as 5000, value without suffix is in unit, ignored by other options.
+    void SetUnit(Unit unit)
+    {
+        if((type == Int32 || type == Uint32 || type == Int64) && unit != this->unit)
+        {
+            this->unit = unit;
+            help_gen++;
+        }
+    }
+    virtual std::string GetValueString(const char *fmt = nullptr) const = 0;
+    virtual std::string GetDefaultValueString(const char *fmt = nullptr) const = 0;
+    virtual std::string GetMinValueString(const char *fmt = nullptr) const = 0;
+    virtual std::string GetMaxValueString(const char *fmt = nullptr) const = 0;
+    // write value (or default, min, max value) into [first, last), without allocating,
+    // integers by to_chars() in base (0 for the option's base, without prefix such as "0x"),
+    // floating points in shortest round trip form, or "%g" like with precision significant
+    // digits if precision >= 0, a list as ',' separated elements, a choice option as it's name,
+    // a bool as "True" or "False", and a string as it is.
+    //   * return : past the end of chars written, nullptr if they don't fit, see FormatSize().
+    char *FormatValue(char *first, char *last, Field field = FieldValue, int base = 0, int precision = -1) const
+    {
+        return format_value(first, last, field, base ? clamp_base(base) : this->base, precision);
+    }
+    // return max chars written by FormatValue() with precision.
+    size_t FormatSize(Field field = FieldValue, int precision = -1) const { return format_size(field, precision); }
+    // append value (or default, min, max value) to buf by FormatValue(),
+    // allocating only if capacity of buf is less than FormatSize() more than it's size.
+    void AppendValueTo(std::string &buf, Field field = FieldValue, int base = 0, int precision = -1) const
+    {
+        const size_t n = buf.size();
+        buf.resize(n + format_size(field, precision));
+        char *e = FormatValue(buf.data() + n, buf.data() + buf.size(), field, base, precision);
+        buf.resize(e ? e - buf.data() : n);
+    }
+    // append a line "name=value" of each of opts (such as a vector<OptionBase *>) to buf,
+    // formatted by AppendValueTo(), sized up front, so that it allocates at most once.
+    template<typename Opts>
+    static void AppendAllValuesTo(std::string &buf, const Opts &opts, int precision = -1)
+    {
+        size_t size = buf.size();
+        for(const OptionBase *opt : opts)
+            size += opt->name.size() + 2 + opt->format_size(FieldValue, precision);
+        buf.reserve(size);
+        for(const OptionBase *opt : opts)
+        {
+            buf.append(opt->name).append(1, '=');
+            opt->AppendValueTo(buf, FieldValue, 0, precision);
+            buf.append(1, '\n');
+        }
+    }
+    // return help text of this option, rendered once and cached until help lines or unit changed,
+    // checked in O(1) by the interned array of help lines and a generation of setters,
+    // not thread safe, like all other members.
+    const std::string &HelpText() const
+    {
+        const OptionHelp lines = help_lines();
+        if(!help_cache || help_cache->lines.lines != lines.lines || help_cache->lines.num != lines.num ||
+                help_cache->gen != help_gen)
+        {
+            if(!help_cache)
+                help_cache.reset(new HelpCache);
+            help_cache->lines = lines;
+            help_cache->gen = help_gen;
+            help_cache->text.clear();
+            help_cache->text.reserve(help_size());
+            render_help(help_cache->text);
+        }
+        return help_cache->text;
+    }
+    // append help text of this option to a growable char buffer.
+    void AppendHelpTo(std::string &buf) const { buf += HelpText(); }
+    // write help text of this option to an output iterator, return the iterator past the end.
+    template<typename OutIt>
+    OutIt WriteHelpTo(OutIt it) const
+    {
+        const std::string &text = HelpText();
+        return std::copy(text.begin(), text.end(), it);
+    }
+    // append help text of this option to a stringstream, or any stream with write(),
+    // a template so that this header needs no iostream.
+    template<typename Stream>
+    void AppendHelpLinesTo(Stream &ss) const
+    {
+        const std::string &text = HelpText();
+        ss.write(text.data(), text.size());
+    }
+    // append help text of all opts (such as a vector<OptionBase *>) to buf, sized up front.
+    template<typename Opts>
+    static void AppendAllHelpTo(std::string &buf, const Opts &opts)
+    {
+        size_t size = buf.size();
+        for(const OptionBase *opt : opts)
+            size += opt->HelpText().size();
+        buf.reserve(size);
+        for(const OptionBase *opt : opts)
+            buf += opt->HelpText();
+    }
+#if(LOYOPTION_VERBOSE)
+    std::string GetStatusNameAndValueString() const
+    {
+        std::string rtn = "[" + GetStatusString() + "] " + std::string(name);
+        if(!alt_name.empty())
+            rtn += ", " + std::string(alt_name);
+        if(list)
+            rtn += " = {" + GetValueString(base == 16 ? "0x%x" : nullptr) + "}";
+        else if(type == String)
+            rtn += " = \"" + GetValueString() + "\"";
+        else
+            rtn += " = " + GetValueString(base == 16 ? "0x%x" : nullptr);
+        return rtn;
+    }
+#endif
+};
+
+// OptionDefine: define an option, will be used by OptionParser.Parse() for parsing args.
+template <typename T, typename = std::enable_if_t< std::is_same_v<T, bool> || std::is_same_v<T, std::string> ||
+        std::is_same_v<T, std::pmr::string> || is_numeric_option_v<T> || is_list_option_v<T> || std::is_enum_v<T> > >
+class Option : public OptionBase
+{
+    friend class OptionParser;
+    static constexpr Type value_type = type_of<T>;
+    // an empty value, with storage from MemoryScope::Current() for pmr::string.
+    static T empty_value()
+    {
+        if constexpr(std::is_same_v<T, std::pmr::string>)
+            return T(MemoryScope::Current());
+        else
+            return T();
+    }
+    T default_val = empty_value();  // default value when there is
+    T value = empty_value();        // value equal to default_val before parsed.
+    T min;              // minimal allowed value.
+    T max;              // maximal allowed value.
+public:
+    // user define help info, will be output formatted by AppendHelpLinesTo(),
+    // lines added by HelpLines.push_back() are interned in MemoryScope::CurrentPool() of construction.
+    OptionHelp HelpLines{&MemoryScope::CurrentPool()};
+    const T &Value()        const { return value; }
+    const T &DefaultValue() const { return default_val; }
+    const T &Min()          const { return min; }
+    const T &Max()          const { return max; }
+    void SetValue(T val)          { value = val; }
+    virtual ~Option() = default;
+    Option() = delete;
+    Option &operator=(const Option<T> &) = delete;
+    Option(Option<T> &&) = delete;
+    
+    // construct a bool type instance.
+    //   * name     : name of the option, such as "-r", "--rst".
+    //   * alt_name : alterative name of the option, such as "--reset".
+    template<typename U = T, typename = std::enable_if_t<std::is_same_v<U, bool>>>
+    Option(std::string_view name, std::string_view alt_name = "") : OptionBase(value_type)
+    {
+        set_names(name, alt_name);
+        this->default_val = false;
+        this->value = false;
+        this->min = std::numeric_limits<T>::lowest();
+        this->max = std::numeric_limits<T>::max();
+    }
+    // construct a non-bool type instance.
+    //   * default_val : default value, used as value when
+    //       * args has not been parsed for the option, or
+    //       * option is not found in args, or
+    //       * option value is missing or invalid.
+    //   * name     : name of the option, such as "-r", "--rst".
+    //   * alt_name : alterative name of the option, such as "--reset".
+    template<typename U = T, typename = std::enable_if_t<
+            std::is_same_v<U, std::string>  || std::is_same_v<U, std::pmr::string> || std::is_same_v<U, int32_t> ||
+            std::is_same_v<U, uint32_t> || std::is_same_v<U, int64_t> || std::is_same_v<U, float> || std::is_same_v<U, double> >>
+    Option(const T &default_val, 
+            std::string_view name, std::string_view alt_name = "") : OptionBase(value_type)
+    {
+        set_names(name, alt_name);
+        this->default_val = default_val;
+        this->value = default_val;
+        if constexpr(!is_string_v<T>)
+        {
+            this->min = std::numeric_limits<T>::lowest();
+            this->max = std::numeric_limits<T>::max();
+        }
+    }
+    // construct a integer(no bool) or floating type instance.
+    //   * default_val : default value, used as value when
+    //       * args has not been parsed for the option, or
+    //       * option is not found in args, or
+    //       * option value is missing or invalid.
+    //   * min      : minimal value allowed, used when parsed value is less then it.
+    //   * max      : maximal value allowed, used when parsed value is larger then it.
+    //   * name     : name of the option, such as "-r", "--rst".
+    //   * alt_name : alterative name of the option, such as "--reset".
+    template<typename U = T, typename = std::enable_if_t<
+            std::is_same_v<U, int32_t> || std::is_same_v<U, uint32_t> || std::is_same_v<U, int64_t> ||
+            std::is_same_v<U, float>   || std::is_same_v<U, double> >>
+    Option(T default_val, T min, T max, 
+            std::string_view name, std::string_view alt_name = "") : OptionBase(value_type)
+    {
+        set_names(name, alt_name);
+        this->default_val = default_val;
+        this->value = default_val;
+        this->min = min;
+        this->max = max;
+    }
+    // construct a integer(no bool) or floating type instance.
+    //   * default_val : default value, used as value when
+    //       * args has not been parsed for the option, or
+    //       * option is not found in args, or
+    //       * option value is missing or invalid.
+    //   * base     : base of the value literal in args, 2~36, commonly 2, 8, 10 and 16.
+    //   * name     : name of the option, such as "-r", "--rst".
+    //   * alt_name : alterative name of the option, such as "--reset".
+    template<typename U = T, typename = std::enable_if_t<
+            std::is_same_v<U, int32_t> || std::is_same_v<U, uint32_t> || std::is_same_v<U, int64_t> ||
+            std::is_same_v<U, float>   || std::is_same_v<U, double> >>
+    Option(T default_val, int base, 
+            std::string_view name, std::string_view alt_name = "") : OptionBase(value_type)
+    {
+        base = clamp_base(base);
+        set_names(name, alt_name);
+        this->base = base;
+        this->default_val = default_val;
+        this->value = default_val;
+        this->min = std::numeric_limits<T>::lowest();
+        this->max = std::numeric_limits<T>::max();
+    }
+    // construct a integer(no bool) or floating type instance.
+    //   * default_val : default value, used as value when
+    //       * args has not been parsed for the option, or
+    //       * option is not found in args, or
+    //       * option value is missing or invalid.
+    //   * base     : base of the value literal in args, 2~36, commonly 2, 8, 10 and 16.
+    //   * min      : minimal value allowed, used when parsed value is less then it.
+    //   * max      : maximal value allowed, used when parsed value is larger then it .
+    //   * name     : name of the option, such as "-r", "--rst".
+    //   * alt_name : alterative name of the option, such as "--reset".
+    template<typename U = T, typename = std::enable_if_t<
+            std::is_same_v<U, int32_t> || std::is_same_v<U, uint32_t> || std::is_same_v<U, int64_t> ||
+            std::is_same_v<U, float>   || std::is_same_v<U, double> >>
+    Option(T default_val, int base, T min, T max, 
+            std::string_view name, std::string_view alt_name = "") : OptionBase(value_type)
+    {
+        base = clamp_base(base);
+        set_names(name, alt_name);
+        this->base = base;
+        this->default_val = default_val;
+        this->value = default_val;
+        this->min = min;
+        this->max = max;
+    }
+private:
+    Option(const Option &) = default;      // by clone() only
+    void reset() final
+    {
+        value = default_val;
+        status = NotParsed;
+        source = FromDefault;
+        matched_name = std::string_view();
+    }
+    std::unique_ptr<OptionBase> clone() const final
+    {
+        std::unique_ptr<Option<T>> opt(new Option<T>(*this));
+        return opt;
+    }
+    void deal_value(std::string_view str) final { deal_scalar(str, value, min, max); }
+    OptionHelp help_lines() const final { return HelpLines; }
+    void save_value(std::string &blob) const final { save_bytes(blob, value); }
+    void load_value(std::string_view bytes) final { load_bytes(bytes, value); }
+    const T &field_of(Field field) const
+    {
+        return field == FieldValue ? value : field == FieldDefault ? default_val : field == FieldMin ? min : max;
+    }
+    char *format_value(char *first, char *last, Field field, int base, int precision) const final
+    {
+        return format_scalar(first, last, field_of(field), base, precision);
+    }
+    size_t format_size(Field field, int precision) const final
+    {
+        return scalar_format_size(field_of(field), precision);
+    }
+    size_t help_size() const final { return scalar_help_size(default_val); }
+    void render_help(std::string &buf) const final { render_scalar_help(buf, default_val, min, max); }
+public:
+    // return a string of value, fmt is a printf like format string
+    std::string GetValueString       (const char *fmt = nullptr) const { return scalar_string(value      , fmt); }
+    // return a string of default value, fmt is a printf like format string
+    std::string GetDefaultValueString(const char *fmt = nullptr) const { return scalar_string(default_val, fmt); }
+    // return a string of min value, fmt is a printf like format string
+    std::string GetMinValueString    (const char *fmt = nullptr) const { return scalar_string(min        , fmt); }
+    // return a string of max value, fmt is a printf like format string
+    std::string GetMaxValueString    (const char *fmt = nullptr) const { return scalar_string(max        , fmt); }
+};
+
+// OptionDefine: define a list option of numeric type E, value such as "1,2,3" in args,
+// and values of all its occurrences in args are appended in order.
+template <typename E>
+class Option<std::vector<E>, void> : public OptionBase
+{
+    friend class OptionParser;
+    using T = std::vector<E>;
+    T default_val;      // default value when there is
+    T value;            // value equal to default_val before parsed.
+    E min;              // minimal allowed value of each element.
+    E max;              // maximal allowed value of each element.
+    size_t par_threshold = 0;   // min length of a value parsed by multiple threads, 0 to disable.
+    size_t par_chunk = 0;       // approximate length of each chunk of the value.
+    unsigned par_threads = 0;   // max number of threads, including the calling one.
+#if(LOYOPTION_THREADS)
+    ParallelExecutor par_exec = &WorkerPool::Execute;   // runs chunks on threads.
+    void *par_ctx = nullptr;    // ctx of par_exec, nullptr for WorkerPool::Shared().
+#endif
+public:
+    // user define help info, will be output formatted by AppendHelpLinesTo(),
+    // lines added by HelpLines.push_back() are interned in MemoryScope::CurrentPool() of construction.
+    OptionHelp HelpLines{&MemoryScope::CurrentPool()};
+    const T &Value()        const { return value; }
+    const T &DefaultValue() const { return default_val; }
+    const E &Min()          const { return min; }
+    const E &Max()          const { return max; }
+    void SetValue(T val)          { value = std::move(val); }
+    // parse a value (an occurrence in args) by multiple threads if it's long enough, it's split
+    // into chunks at ',' and elements converted concurrently, then appended in order, with
+    // the same result and status as parsing in one thread.
+    // threads are of WorkerPool::Shared(), started once and reused, or of SetParallelExecutor(),
+    // a value is parsed in the calling thread if the pool is busy with another one.
+    //   * threshold  : min length of a value to be split, shorter ones are parsed in the
+    //                  calling thread, 0 to disable, a few MiB is where threads pay off.
+    //   * chunk_size : approximate length of each chunk, at least 1.
+    //   * threads    : max number of threads including the calling one,
+    //                  0 for thread::hardware_concurrency().
+    // e.g. SetParallel() for a "--ids" of an export with millions of elements.
+    void SetParallel(size_t threshold = 1 << 22, size_t chunk_size = 1 << 18, unsigned threads = 0)
+    {
+        par_threshold = threshold;
+        par_chunk = chunk_size ? chunk_size : 1;
+        par_threads = threads;
+    }
+#if(LOYOPTION_THREADS)
+    // run parallel parsing on a caller's thread pool by fn with ctx, see ParallelExecutor,
+    // nullptr fn for WorkerPool::Shared().
+    void SetParallelExecutor(ParallelExecutor fn, void *ctx = nullptr)
+    {
+        par_exec = fn ? fn : &WorkerPool::Execute;
+        par_ctx = fn ? ctx : nullptr;
+    }
+#endif
+    virtual ~Option() = default;
+    Option() = delete;
+    Option &operator=(const Option<T> &) = delete;
+    Option(Option<T> &&) = delete;
+
+    // construct a list option instance.
+    //   * default_val : default value, used as value when
+    //       * args has not been parsed for the option, or
+    //       * option is not found in args, or
+    //       * option value is missing or invalid.
+    //   * base     : base of the element literals in args, 2~36, commonly 2, 8, 10 and 16.
+    //   * min      : minimal value allowed, used when parsed element is less then it.
+    //   * max      : maximal value allowed, used when parsed element is larger then it.
+    //   * name     : name of the option, such as "-r", "--rst".
+    //   * alt_name : alterative name of the option, such as "--reset".
+    Option(const T &default_val, int base, E min, E max,
+            std::string_view name, std::string_view alt_name = "") : OptionBase(type_of<E>, true)
+    {
+        base = clamp_base(base);
+        set_names(name, alt_name);
+        this->base = base;
+        this->default_val = default_val;
+        this->value = default_val;
+        this->min = min;
+        this->max = max;
+    }
+    Option(const T &default_val, std::string_view name, std::string_view alt_name = "")
+        : Option(default_val, 10, std::numeric_limits<E>::lowest(), std::numeric_limits<E>::max(), name, alt_name) {}
+    Option(const T &default_val, E min, E max, std::string_view name, std::string_view alt_name = "")
+        : Option(default_val, 10, min, max, name, alt_name) {}
+    Option(const T &default_val, int base, std::string_view name, std::string_view alt_name = "")
+        : Option(default_val, base, std::numeric_limits<E>::lowest(), std::numeric_limits<E>::max(), name, alt_name) {}
+private:
+    Option(const Option &) = default;      // by clone() only
+    void reset() final
+    {
+        value = default_val;
+        status = NotParsed;
+        source = FromDefault;
+        matched_name = std::string_view();
+    }
+    std::unique_ptr<OptionBase> clone() const final
+    {
+        std::unique_ptr<Option<T>> opt(new Option<T>(*this));
+        return opt;
+    }
+    OptionHelp help_lines() const final { return HelpLines; }
+    void save_value(std::string &blob) const final { save_bytes(blob, value); }
+    void load_value(std::string_view bytes) final { load_bytes(bytes, value); }
+    // parse 1~8 decimal digits by SWAR (SIMD within a register), 8 digits at once.
+    //   * return : false if any char is not a digit.
+    static bool parse_digits8(const char *p, size_t n, uint32_t &val)
+    {
+        uint64_t x = 0x3030303030303030ull;     // '0' padded
+        memcpy((char *)&x + (8 - n), p, n);
+        if((((x & 0xf0f0f0f0f0f0f0f0ull) | (((x + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4))
+                != 0x3333333333333333ull))
+            return false;
+        x -= 0x3030303030303030ull;
+        x = (x * 10) + (x >> 8);
+        x = (((x & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) +
+             (((x >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >> 32;
+        val = (uint32_t)x;
+        return true;
+    }
+    // parse an element, by SWAR for short decimal integers, else by parse_numeric().
+    NumericResult parse_element(const char *p, const char *end, E &val) const
+    {
+        if constexpr(std::is_integral_v<E>)
+        {
+            if(unit != NoUnit)
+                return parse_unit(std::string_view(p, end - p), base, unit, val);
+        }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if constexpr(std::is_integral_v<E>)
+        {   // up to 16 digits, as 2 groups of 8 digits.
+            const bool neg = p < end && *p == '-';
+            const char *d = p + neg;
+            const size_t n = end - d;
+            uint32_t hi = 0, lo;
+            if(base == 10 && 0 < n && n <= 16 && (!neg || std::is_signed_v<E>) &&
+                    (n <= 8 || parse_digits8(d, n - 8, hi)) &&
+                    parse_digits8(d + (n > 8 ? n - 8 : 0), n > 8 ? 8 : n, lo))
+            {
+                using U = std::make_unsigned_t<E>;
+                const uint64_t mag = hi * 100000000ull + lo;
+                const uint64_t lim = neg ? (uint64_t)std::numeric_limits<E>::max() + 1 : std::numeric_limits<U>::max();
+                if(mag <= lim)
+                {
+                    val = (E)(neg ? (U)(0 - (U)mag) : (U)mag);
+                    return NumParsed;
+                }
+            }
+        }
+#endif
+        return parse_numeric(std::string_view(p, end - p), base, val);
+    }
+    // parse ',' separated elements in [p, end) and append them to out,
+    // st is updated from Parsed by the 1st clamped element.
+    //   * return : NumParsed, or result of the 1st invalid or overflowed element.
+    NumericResult parse_elements(const char *p, const char *end, T &out, Status &st) const
+    {
+        for(;;)
+        {
+            const char *q = (const char *)memchr(p, ',', end - p);
+            if(!q)
+                q = end;
+            E val;
+            const NumericResult res = parse_element(p, q, val);
+            switch(res)
+            {
+            case NumParsed:
+                if(val < min || val > max)
+                {
+                    if(st == Parsed)
+                        st = val < min ? ClampedMin : ClampedMax;
+                    val = val < min ? min : max;
+                }
+                break;
+            case NumNegative:
+                if(st == Parsed)
+                    st = ClampedMin;
+                val = min;
+                break;
+            case NumOverflow:
+            {
+                const Status c = clamp_overflow(std::string_view(p, q - p), min, max, val);
+                if(c == ValueOverflow)
+                    return res;
+                if(st == Parsed)
+                    st = c;
+                break;
+            }
+            default:
+                return res;
+            }
+            out.push_back(val);
+            if(q == end)
+                return NumParsed;
+            p = q + 1;
+        }
+    }
+#if(LOYOPTION_THREADS)
+    // parse_elements() of chunks of [p, end) by multiple threads, results are appended in order.
+    NumericResult parse_parallel(const char *p, const char *end, T &out, Status &st) const
+    {
+        struct Chunk
+        {
+            size_t begin, end;  // offsets in [p, end).
+            T vals;
+            Status st = Parsed;
+            NumericResult res = NumParsed;
+        };
+        unsigned num_threads = par_threads ? par_threads : std::thread::hardware_concurrency();
+        if(num_threads <= 1)
+        {
+            out.reserve(out.size() + 1 + std::count(p, end, ','));
+            return parse_elements(p, end, out, st);
+        }
+        const size_t len = end - p;
+        std::vector<Chunk> chunks;
+        chunks.reserve(len / par_chunk + 1);
+        for(size_t b = 0;;)
+        {   // cut after the 1st ',' at or after b + par_chunk.
+            const char *q = b + par_chunk < len ?
+                    (const char *)memchr(p + b + par_chunk, ',', len - b - par_chunk) : nullptr;
+            const size_t e = q ? q - p : len;
+            chunks.push_back(Chunk{b, e, T(), Parsed, NumParsed});
+            if(!q)
+                break;
+            b = e + 1;
+        }
+        num_threads = (unsigned)std::min<size_t>(chunks.size(), num_threads);
+        std::atomic<size_t> next{0};
+        auto work = [&]()
+        {
+            for(size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < chunks.size();)
+            {
+                Chunk &c = chunks[i];
+                c.vals.reserve(1 + std::count(p + c.begin, p + c.end, ','));
+                c.res = parse_elements(p + c.begin, p + c.end, c.vals, c.st);
+            }
+        };
+        using Work = decltype(work);
+        par_exec([](void *w) { (*static_cast<Work *>(w))(); }, &work, num_threads, par_ctx);
+        work();     // chunks left, if the executor called it less than once.
+        size_t total = out.size();
+        for(const Chunk &c : chunks)
+            total += c.vals.size();
+        out.reserve(total);
+        for(const Chunk &c : chunks)
+        {
+            if(st == Parsed)
+                st = c.st;
+            if(c.res != NumParsed)
+                return c.res;
+            out.insert(out.end(), c.vals.begin(), c.vals.end());
+        }
+        return NumParsed;
+    }
+#endif
+    // append elements in str to value.
+    void deal_value(std::string_view str) final
+    {
+        if(status == ValueInvalid || status == ValueOverflow)
+            return;     // keep the 1st error.
+        if(status == NotParsed)
+        {   // the 1st occurrence replaces the default value.
+            value.clear();
+            status = Parsed;
+        }
+        const char *p = str.data(), *end = p + str.size();
+        if(p == end)
+            return;
+        NumericResult res;
+#if(LOYOPTION_THREADS)
+        if(par_threshold && str.size() >= par_threshold)
+            res = parse_parallel(p, end, value, status);
+        else
+#endif
+        {
+            value.reserve(value.size() + 1 + std::count(p, end, ','));
+            res = parse_elements(p, end, value, status);
+        }
+        if(res != NumParsed)
+        {
+            status = res == NumOverflow ? ValueOverflow : ValueInvalid;
+            value = default_val;
+        }
+    }
+    char *format_value(char *first, char *last, Field field, int base, int precision) const final
+    {
+        if(field == FieldMin || field == FieldMax)
+            return format_scalar(first, last, field == FieldMin ? min : max, base, precision);
+        const T &v = field == FieldValue ? value : default_val;
+        for(size_t i = 0; i < v.size() && first; i++)
+        {
+            if(i && first == last)
+                return nullptr;
+            if(i)
+                *first++ = ',';
+            first = format_scalar(first, last, v[i], base, precision);
+        }
+        return first;
+    }
+    size_t format_size(Field field, int precision) const final
+    {
+        const size_t n = field == FieldValue ? value.size() : field == FieldDefault ? default_val.size() : 1;
+        return n * (scalar_format_size(min, precision) + 1);
+    }
+    std::string get_elem_string(E v, const char *fmt) const
+    {
+        if(!fmt)
+            return std::to_string(v);
+        char str[256];
+        snprintf(str, 255, fmt, v);
+        return str;
+    }
+    std::string get_val_string(const T &v, const char *fmt = nullptr) const
+    {
+        std::string rtn;
+        for(size_t i = 0; i < v.size(); i++)
+        {
+            if(i)
+                rtn += ',';
+            rtn += get_elem_string(v[i], fmt);
+        }
+        return rtn;
+    }
+public:
+    // return a string of value, elements separated by ',', fmt is a printf like format string of each
+    std::string GetValueString       (const char *fmt = nullptr) const { return get_val_string(value      , fmt); }
+    // return a string of default value, elements separated by ',', fmt is a printf like format string of each
+    std::string GetDefaultValueString(const char *fmt = nullptr) const { return get_val_string(default_val, fmt); }
+    // return a string of min value, fmt is a printf like format string
+    std::string GetMinValueString    (const char *fmt = nullptr) const { return get_elem_string(min      , fmt); }
+    // return a string of max value, fmt is a printf like format string
+    std::string GetMaxValueString    (const char *fmt = nullptr) const { return get_elem_string(max      , fmt); }
+    size_t help_size() const final
+    {
+        return help_base_size() + (2 + default_val.size()) * max_literal_size;
+    }
+    void render_help(std::string &buf) const final
+    {
+        append_help_names(buf, " <values>");
+        buf.append(", values are a ',' separated list of ");
+        if constexpr(std::is_integral_v<E>)
+        {
+            buf.append(std::is_unsigned_v<E> ? "unsigned integer literals" : "integer literals");
+            append_help_base(buf);
+            append_help_unit(buf);
+        }
+        else
+            buf.append("floating point literals");
+        buf.append(", default = {");
+        for(size_t i = 0; i < default_val.size(); i++)
+            append_literal(buf.append(i ? "," : ""), default_val[i], base);
+        buf.append(1, '}');
+        if(min != std::numeric_limits<E>::lowest() && max != std::numeric_limits<E>::max())
+        {
+            append_literal(buf.append(", range = ["), min, base);
+            append_literal(buf.append(", "), max, base);
+            buf.append(1, ']');
+        }
+        buf.append(", can be repeated.\n");
+        append_help_lines(buf);
+    }
+};
+
+// OptionDefine: define a choice option of enum type E, value is a name in a ChoiceSet,
+// such as "--mode fast" for Mode::Fast, so that users switch on an enum instead of
+// comparing strings, see ChoiceSet.
+template <typename E>
+class Option<E, std::enable_if_t<std::is_enum_v<E>>> : public OptionBase
+{
+    friend class OptionParser;
+    E default_val;      // default value when there is
+    E value;            // value equal to default_val before parsed.
+    const void *choices;                // the ChoiceSet<E, N>.
+    size_t (*find_choice)(const void *choices, std::string_view name);
+    const std::string_view *choice_names;    // names of the ChoiceSet.
+    const E *choice_values;                  // values of the ChoiceSet.
+    size_t num_choices;
+    template<size_t N>
+    static size_t find_in(const void *choices, std::string_view name)
+    {
+        return static_cast<const ChoiceSet<E, N> *>(choices)->Find(name);
+    }
+public:
+    // user define help info, will be output formatted by AppendHelpLinesTo(),
+    // lines added by HelpLines.push_back() are interned in MemoryScope::CurrentPool() of construction.
+    OptionHelp HelpLines{&MemoryScope::CurrentPool()};
+    const E &Value()        const { return value; }
+    const E &DefaultValue() const { return default_val; }
+    void SetValue(E val)          { value = val; }
+    // return name of v in the ChoiceSet, empty if v is not in it.
+    std::string_view NameOf(E v) const
+    {
+        for(size_t i = 0; i < num_choices; i++)
+            if(choice_values[i] == v)
+                return choice_names[i];
+        return std::string_view();
+    }
+    virtual ~Option() = default;
+    Option() = delete;
+    Option &operator=(const Option &) = delete;
+    Option(Option &&) = delete;
+
+    // construct a choice option instance.
+    //   * default_val : default value, used as value when
+    //       * args has not been parsed for the option, or
+    //       * option is not found in args, or
+    //       * option value is missing or invalid (not a name in choices).
+    //   * choices  : allowed names and their values, must outlive the instance.
+    //   * name     : name of the option, such as "-m", "--mode".
+    //   * alt_name : alterative name of the option, such as "--method".
+    template<size_t N>
+    Option(E default_val, const ChoiceSet<E, N> &choices,
+            std::string_view name, std::string_view alt_name = "") : OptionBase(type_of<E>)
+    {
+        set_names(name, alt_name);
+        this->default_val = default_val;
+        this->value = default_val;
+        this->choices = &choices;
+        this->find_choice = &find_in<N>;
+        this->choice_names = choices.Names();
+        this->choice_values = choices.Values();
+        this->num_choices = N;
+    }
+private:
+    Option(const Option &) = default;      // by clone() only
+    void reset() final
+    {
+        value = default_val;
+        status = NotParsed;
+        source = FromDefault;
+        matched_name = std::string_view();
+    }
+    std::unique_ptr<OptionBase> clone() const final
+    {
+        std::unique_ptr<Option> opt(new Option(*this));
+        return opt;
+    }
+    void deal_value(std::string_view str) final
+    {
+        const size_t e = find_choice(choices, str);
+        if(e)
+        {
+            value = choice_values[e - 1];
+            status = Parsed;
+        }
+        else
+            status = ValueInvalid;
+    }
+    OptionHelp help_lines() const final { return HelpLines; }
+    size_t num_value_names() const final { return num_choices; }
+    std::string_view value_name(size_t i) const final { return choice_names[i]; }
+    void save_value(std::string &blob) const final { save_bytes(blob, value); }
+    void load_value(std::string_view bytes) final { load_bytes(bytes, value); }
+    std::string get_val_string(E v) const
+    {
+        const std::string_view n = NameOf(v);
+        return n.data() ? std::string(n) : std::to_string((int64_t)v);
+    }
+    // name of field, empty if it's not in the ChoiceSet.
+    std::string_view field_name(Field field) const
+    {
+        return field == FieldValue   ? NameOf(value)       : field == FieldDefault ? NameOf(default_val) :
+               field == FieldMin     ? choice_names[0]    : choice_names[num_choices - 1];
+    }
+    char *format_value(char *first, char *last, Field field, int base, int precision) const final
+    {
+        const std::string_view n = field_name(field);
+        if(n.data())
+            return format_scalar(first, last, n, base, precision);
+        return format_scalar(first, last, (int64_t)(field == FieldValue ? value : default_val), 10, precision);
+    }
+    size_t format_size(Field field, int precision) const final
+    {
+        const std::string_view n = field_name(field);
+        return n.data() ? n.size() : scalar_format_size((int64_t)0, precision);
+    }
+    size_t help_size() const final
+    {
+        size_t size = help_base_size() + max_literal_size;
+        for(size_t i = 0; i < num_choices; i++)
+            size += choice_names[i].size() + 1;
+        return size;
+    }
+    void render_help(std::string &buf) const final
+    {
+        append_help_names(buf, " <value>");
+        buf.append(", value is one of ");
+        for(size_t i = 0; i < num_choices; i++)
+            buf.append(i ? "|" : "").append(choice_names[i]);
+        buf.append(", default = ").append(get_val_string(default_val)).append(".\n");
+        append_help_lines(buf);
+    }
+public:
+    // return name of value, or it's integer value if it's not in the ChoiceSet, fmt is ignored.
+    std::string GetValueString       (const char * = nullptr) const { return get_val_string(value); }
+    // return name of default value, or it's integer value if it's not in the ChoiceSet.
+    std::string GetDefaultValueString(const char * = nullptr) const { return get_val_string(default_val); }
+    // return name of the 1st choice.
+    std::string GetMinValueString    (const char * = nullptr) const { return std::string(choice_names[0]); }
+    // return name of the last choice.
+    std::string GetMaxValueString    (const char * = nullptr) const { return std::string(choice_names[num_choices - 1]); }
+};
+
+// StaticString: a string_view argument of a StaticOption constructor, such as a name, whose length
+// of a C string is counted by a constexpr loop, as gcc doesn't constant initialize a global
+// (without constinit) through char_traits::length() of a string_view from a string literal.
+struct StaticString
+{
+    std::string_view str;
+    constexpr StaticString() = default;
+    constexpr StaticString(std::string_view str) : str(str) {}
+    constexpr StaticString(const char *s) : str(s, length(s)) {}
+    constexpr operator std::string_view() const { return str; }
+private:
+    static constexpr size_t length(const char *s)
+    {
+        size_t n = 0;
+        while(s[n])
+            n++;
+        return n;
+    }
+};
+
+// StaticOption: define an option with all its definition constexpr, name, alt_name, default,
+// min, max, base and help lines, so that a global one is constant initialized without
+// dynamic initialization before main(), only value and status are changed at runtime.
+//   * T : bool, string_view, int32_t, uint32_t, int64_t, float or double,
+//         a string_view value is a view into args, valid while argv (and response files
+//         of the OptionParser parsed it) are alive.
+// e.g.:
+//   static constexpr string_view f_help[] = { "Test option f, an integer option." };
+//   LOYOPTION_CONSTINIT StaticOption<int32_t> opt_int32_f(50, 0, 100, "-f", "--int32_f", f_help);
+template <typename T, typename = std::enable_if_t< std::is_same_v<T, bool> || std::is_same_v<T, std::string_view> ||
+        is_numeric_option_v<T> > >
+class StaticOption : public OptionBase
+{
+    friend class OptionParser;
+    static constexpr Type value_type = type_of<T>;
+    using Arg = std::conditional_t<std::is_same_v<T, std::string_view>, StaticString, T>;  // T of arguments.
+    T default_val;      // default value when there is
+    T value;            // value equal to default_val before parsed.
+    T min;              // minimal allowed value.
+    T max;              // maximal allowed value.
+    OptionHelp help;    // help lines.
+    static constexpr T lowest() { if constexpr(is_numeric_option_v<T>) return std::numeric_limits<T>::lowest(); else return T(); }
+    static constexpr T highest() { if constexpr(is_numeric_option_v<T>) return std::numeric_limits<T>::max(); else return T(); }
+public:
+    constexpr const T &Value()        const { return value; }
+    constexpr const T &DefaultValue() const { return default_val; }
+    constexpr const T &Min()          const { return min; }
+    constexpr const T &Max()          const { return max; }
+    void SetValue(T val)                    { value = val; }
+    virtual ~StaticOption() = default;
+    StaticOption() = delete;
+    StaticOption &operator=(const StaticOption &) = delete;
+    StaticOption(StaticOption &&) = delete;
+
+    // construct a bool type instance, see Option<bool>.
+    //   * help : help lines, an array of string_view with static storage.
+    template<typename U = T, typename = std::enable_if_t<std::is_same_v<U, bool>>>
+    constexpr StaticOption(StaticString name, StaticString alt_name = {}, OptionHelp help = {})
+        : StaticOption(false, 10, false, true, name, alt_name, help, 0) {}
+    // construct a non-bool type instance, see Option<T>.
+    template<typename U = T, typename = std::enable_if_t<!std::is_same_v<U, bool>>>
+    constexpr StaticOption(Arg default_val, StaticString name, StaticString alt_name = {}, OptionHelp help = {})
+        : StaticOption(default_val, 10, lowest(), highest(), name, alt_name, help, 0) {}
+    // construct a integer(no bool) or floating type instance, see Option<T>.
+    template<typename U = T, typename = std::enable_if_t<is_numeric_option_v<U>>>
+    constexpr StaticOption(T default_val, T min, T max,
+            StaticString name, StaticString alt_name = {}, OptionHelp help = {})
+        : StaticOption(default_val, 10, min, max, name, alt_name, help, 0) {}
+    // construct a integer(no bool) or floating type instance, see Option<T>.
+    template<typename U = T, typename = std::enable_if_t<is_numeric_option_v<U>>>
+    constexpr StaticOption(T default_val, int base,
+            StaticString name, StaticString alt_name = {}, OptionHelp help = {})
+        : StaticOption(default_val, base, lowest(), highest(), name, alt_name, help, 0) {}
+    // construct a integer(no bool) or floating type instance, see Option<T>.
+    template<typename U = T, typename = std::enable_if_t<is_numeric_option_v<U>>>
+    constexpr StaticOption(T default_val, int base, T min, T max,
+            StaticString name, StaticString alt_name = {}, OptionHelp help = {})
+        : StaticOption(default_val, base, min, max, name, alt_name, help, 0) {}
+private:
+    constexpr StaticOption(T default_val, int base, T min, T max,
+            StaticString name, StaticString alt_name, OptionHelp help, int)
+        : OptionBase(value_type), default_val(default_val), value(default_val),
+          min(min), max(max), help(help)
+    {
+        this->name = name;
+        this->alt_name = alt_name;
+        this->base = clamp_base(base);
+    }
+    StaticOption(const StaticOption &) = default;   // by clone() only
+    void reset() final
+    {
+        value = default_val;
+        status = NotParsed;
+        source = FromDefault;
+        matched_name = std::string_view();
+    }
+    std::unique_ptr<OptionBase> clone() const final
+    {
+        return std::unique_ptr<OptionBase>(new StaticOption(*this));
+    }
+    void deal_value(std::string_view str) final { deal_scalar(str, value, min, max); }
+    OptionHelp help_lines() const final { return help; }
+    void save_value(std::string &blob) const final { save_bytes(blob, value); }
+    void load_value(std::string_view bytes) final { load_bytes(bytes, value); }
+    const T &field_of(Field field) const
+    {
+        return field == FieldValue ? value : field == FieldDefault ? default_val : field == FieldMin ? min : max;
+    }
+    char *format_value(char *first, char *last, Field field, int base, int precision) const final
+    {
+        return format_scalar(first, last, field_of(field), base, precision);
+    }
+    size_t format_size(Field field, int precision) const final
+    {
+        return scalar_format_size(field_of(field), precision);
+    }
+    size_t help_size() const final { return scalar_help_size(default_val); }
+    void render_help(std::string &buf) const final { render_scalar_help(buf, default_val, min, max); }
+public:
+    // return a string of value, fmt is a printf like format string
+    std::string GetValueString       (const char *fmt = nullptr) const { return scalar_string(value      , fmt); }
+    // return a string of default value, fmt is a printf like format string
+    std::string GetDefaultValueString(const char *fmt = nullptr) const { return scalar_string(default_val, fmt); }
+    // return a string of min value, fmt is a printf like format string
+    std::string GetMinValueString    (const char *fmt = nullptr) const { return scalar_string(min        , fmt); }
+    // return a string of max value, fmt is a printf like format string
+    std::string GetMaxValueString    (const char *fmt = nullptr) const { return scalar_string(max        , fmt); }
+};
+
+// stable sort of v by less, a bottom-up merge sort with a scratch buffer from the memory_resource
+// of v, unlike std::stable_sort() whose buffer is from the global operator new.
+template<typename T, typename Less = std::less<T>>
+void stable_sort_in_place(std::pmr::vector<T> &v, Less less = Less())
+{
+    const size_t n = v.size();
+    if(n < 2)
+        return;
+    std::pmr::vector<T> scratch(n, v.get_allocator());
+    T *a = v.data(), *b = scratch.data();
+    for(size_t w = 1; w < n; w *= 2)
+    {
+        for(size_t lo = 0; lo < n; lo += 2 * w)
+        {
+            const size_t mid = std::min(lo + w, n), hi = std::min(lo + 2 * w, n);
+            std::merge(a + lo, a + mid, a + mid, a + hi, b + lo, less);
+        }
+        std::swap(a, b);
+    }
+    if(a != v.data())
+        std::copy(a, a + n, v.data());
+}
+
+// NameTrie: a compact trie of option names, looking up a name exactly, or by a unique prefix
+// (GNU style abbreviation), both in O(length of the name), built once for ParseAll().
+class NameTrie
+{
+public:
+    struct Entry
+    {
+        std::string_view name;
+        size_t id;      // id of the option, e.g. index in opts of ParseAll().
+    };
+    enum Match : uint8_t
+    {
+        Miss,           // not a name, nor a prefix of any name.
+        Exact,          // a name.
+        Prefix,         // a prefix of names all of a single id.
+        Ambiguous       // a prefix of names of different ids.
+    };
+    struct Result
+    {
+        Match match;
+        size_t entry;   // the entry, the 1st one with the prefix for Prefix.
+        size_t lo, hi;  // all entries with the prefix for Ambiguous, [lo, hi).
+    };
+private:
+    struct Node
+    {
+        uint32_t lo, hi;        // entries whose name start with the prefix of this node, sorted.
+        uint32_t edge, num;     // children in edges, [edge, edge + num), sorted by char.
+        int32_t exact;          // entry whose name is the prefix, -1 if none.
+        bool unique;            // all entries in [lo, hi) are of the same id.
+    };
+    struct Edge
+    {
+        uint8_t c;
+        uint32_t node;
+    };
+    std::pmr::vector<Entry> entries; // sorted by name, entries of a same name in order of adding.
+    std::pmr::vector<Node> nodes;    // nodes[0] is the root.
+    std::pmr::vector<Edge> edges;
+    // build node of prefix of length depth of entries [lo, hi), return its index.
+    uint32_t build(uint32_t lo, uint32_t hi, size_t depth)
+    {
+        const uint32_t n = (uint32_t)nodes.size();
+        nodes.push_back({lo, hi, 0, 0, -1, true});
+        uint32_t i = lo;
+        if(i < hi && entries[i].name.size() == depth)
+        {   // a duplicated name keeps the 1st one.
+            nodes[n].exact = (int32_t)i;
+            while(i < hi && entries[i].name.size() == depth)
+                i++;
+        }
+        for(uint32_t j = lo + 1; j < hi && nodes[n].unique; j++)
+            nodes[n].unique = entries[j].id == entries[lo].id;
+        uint32_t num = 0;
+        for(uint32_t j = i; j < hi; j++)
+            num += j == i || entries[j].name[depth] != entries[j - 1].name[depth];
+        const uint32_t edge = (uint32_t)edges.size();
+        edges.resize(edge + num);
+        nodes[n].edge = edge;
+        nodes[n].num = num;
+        for(uint32_t e = edge; i < hi; e++)
+        {
+            uint32_t j = i + 1;
+            while(j < hi && entries[j].name[depth] == entries[i].name[depth])
+                j++;
+            const uint8_t c = (uint8_t)entries[i].name[depth];
+            const uint32_t child = build(i, j, depth + 1);
+            edges[e] = {c, child};
+            i = j;
+        }
+        return n;
+    }
+public:
+    // storage is from mem, or MemoryScope::Current() if nullptr.
+    explicit NameTrie(std::pmr::memory_resource *mem = nullptr)
+        : entries(mem ? mem : MemoryScope::Current()), nodes(entries.get_allocator().resource()),
+          edges(entries.get_allocator().resource()) {}
+    // rebuild the trie of entries [first, first + num), capacity is reused.
+    void Build(const Entry *first, size_t num)
+    {
+        this->entries.assign(first, first + num);
+        stable_sort_in_place(this->entries,
+                [](const Entry &a, const Entry &b) { return a.name < b.name; });
+        nodes.clear();
+        edges.clear();
+        nodes.reserve(this->entries.size() * 4 + 1);
+        build(0, (uint32_t)this->entries.size(), 0);
+    }
+    void Build(const std::vector<Entry> &entries) { Build(entries.data(), entries.size()); }
+    bool Empty() const { return entries.empty(); }
+    const Entry &GetEntry(size_t i) const { return entries[i]; }
+    // look up name exactly, and by a unique prefix if allow_prefix.
+    Result Lookup(std::string_view name, bool allow_prefix) const
+    {
+        if(nodes.empty())
+            return {Miss, 0, 0, 0};
+        const Node *node = &nodes[0];
+        for(char c : name)
+        {
+            const Edge *b = edges.data() + node->edge, *e = b + node->num;
+            const Edge *it = std::lower_bound(b, e, (uint8_t)c, [](const Edge &x, uint8_t c) { return x.c < c; });
+            if(it == e || it->c != (uint8_t)c)
+                return {Miss, 0, 0, 0};
+            node = &nodes[it->node];
+        }
+        if(node->exact >= 0)
+            return {Exact, (size_t)node->exact, node->lo, node->hi};
+        if(!allow_prefix || node->lo == node->hi)
+            return {Miss, 0, 0, 0};
+        return {node->unique ? Prefix : Ambiguous, node->lo, node->lo, node->hi};
+    }
+};
+
+// OptionEvent: an event of parsing args, delivered to the observer set by OptionParser::SetObserver(),
+// or by OptionParser::SetDefaultObserver().
+struct OptionEvent
+{
+    enum Kind : uint8_t
+    {
+        ArgTokenized , // arg added to args, from argv, merged short flags or a response file.
+        OptionMatched, // arg matched a name of opt.
+        ValueClamped , // arg as value of opt clamped, status of opt is ClampedMax or ClampedMin.
+        ValueInvalid , // arg as value of opt invalid or overflow, or value of opt not found.
+        UnparsedArg  , // arg left unparsed by ParseAll().
+        OptionParsed   // opt updated by Parse() or ParseAll(), with its final status.
+    };
+    Kind kind;
+    const char *where;      // the parsing function, such as "OptionParser::ParseAll()".
+    uint64_t time_ns;       // timestamp of steady_clock in nanoseconds.
+    size_t index;           // index of arg in args, SIZE_MAX for OptionParsed.
+    size_t offset;          // byte offset of arg in the command line (argv joined by ' '),
+                            // or in the response file it comes from.
+    std::string_view arg;   // the arg, empty for OptionParsed.
+    const OptionBase *opt;  // the option, nullptr for ArgTokenized and UnparsedArg.
+};
+// observer of all parsing events, ctx is the one set with it.
+using OptionObserver = void (*)(const OptionEvent &ev, void *ctx);
+
+class OptionParser
+{
+    template<typename... Opts> friend class OptionSet;
+    friend class CommandSet;
+    friend class OptionStream;
+private:
+    MemoryCounter mem;          // storage of all containers below, declared first.
+#if(LOYOPTION_OBSERVER)
+#if(LOYOPTION_VERBOSE)
+    // the default observer, prints args and results of parsing as debug info.
+    static void verbose_observer(const OptionEvent &ev, void *)
+    {
+        if(ev.kind == OptionEvent::ArgTokenized)
+        {
+            if(ev.index == 0)
+                fputs("[debug info] OptionParser.args:\n", stdout);
+            printf("[debug info]     %.*s\n", (int)ev.arg.size(), ev.arg.data());
+        }
+        else if(ev.kind == OptionEvent::OptionParsed)
+        {
+            printf("[debug info] %s : %s\n", ev.where, ev.opt->GetStatusNameAndValueString().c_str());
+        }
+    }
+    static inline OptionObserver default_observer = &verbose_observer;
+#else
+    static inline OptionObserver default_observer = nullptr;
+#endif
+    static inline void *default_observer_ctx = nullptr;
+    OptionObserver observer = default_observer;     // observer of this instance, see SetObserver().
+    void *observer_ctx = default_observer_ctx;
+    std::pmr::vector<size_t> offsets{&mem};  // offsets[i] is byte offset of args[i], only while observed.
+#endif
+    // emit an event of args[i], or of arg if it's not empty, by a single call of the observer if set,
+    // compiled to nothing without LOYOPTION_OBSERVER.
+    void emit(OptionEvent::Kind kind, const char *where, size_t i, const OptionBase *opt = nullptr,
+            std::string_view arg = std::string_view()) const
+    {
+#if(LOYOPTION_OBSERVER)
+        if(!observer)
+            return;
+        const OptionEvent ev
+        {
+            kind, where,
+            (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count(),
+            i, i < offsets.size() ? offsets[i] : 0,
+            !arg.empty() ? arg : i < args.size() ? args[i] : std::string_view(), opt
+        };
+        observer(ev, observer_ctx);
+#else
+        (void)kind; (void)where; (void)i; (void)opt; (void)arg;
+#endif
+    }
+    // emit UnparsedArg for all unparsed args, see unparsed_arg().
+    void emit_unparsed(const char *where) const
+    {
+#if(LOYOPTION_OBSERVER)
+        if(!observer)
+            return;
+        for(size_t i = first_undealed; i < args.size(); i = next_unparsed(i))
+            emit(OptionEvent::UnparsedArg, where, i, nullptr, unparsed_arg(i));
+#else
+        (void)where;
+#endif
+    }
+    // emit ValueClamped or ValueInvalid by status of opt updated from prev, for value in args[i].
+    void emit_value_status(const OptionBase &opt, OptionBase::Status prev, const char *where, size_t i) const
+    {
+#if(LOYOPTION_OBSERVER)
+        if(!observer || opt.status == prev)
+            return;
+        switch(opt.status)
+        {
+        case OptionBase::ClampedMax    :
+        case OptionBase::ClampedMin    : emit(OptionEvent::ValueClamped, where, i, &opt); break;
+        case OptionBase::ValueInvalid  :
+        case OptionBase::ValueNotFound :
+        case OptionBase::ValueOverflow : emit(OptionEvent::ValueInvalid, where, i, &opt); break;
+        default                        : break;
+        }
+#else
+        (void)opt; (void)prev; (void)where; (void)i;
+#endif
+    }
+    // views into argv, response files, or the short flag table for merged short flags.
+    std::pmr::vector<std::string_view> args{&mem};
+    std::pmr::vector<uint64_t> dealed{&mem}; // bitset, bit i is set if args[i] has been dealed.
+    std::pmr::vector<uint64_t> valued{&mem}; // bitset, bit i is set if args[i] has been dealed as a value.
+    size_t num_dealed = 0;      // number of set bits in dealed.
+    size_t first_undealed = 0;  // index of the 1st arg not dealed, args.size() if none.
+    std::string exec_name;
+    void get_exec_name()
+    {
+        size_t pos = args[0].find_last_of("/\\");
+        exec_name = args[0].substr(pos == std::string_view::npos ? 0 : pos + 1);
+    }
+    static size_t count_trailing_zeros(uint64_t x)
+    {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return i;
+#else
+        return __builtin_ctzll(x);
+#endif
+    }
+    bool is_dealed(size_t i) const { return dealed[i >> 6] >> (i & 63) & 1; }
+    bool is_valued(size_t i) const { return valued[i >> 6] >> (i & 63) & 1; }
+    void set_valued(size_t i)
+    {
+        valued[i >> 6] |= (uint64_t)1 << (i & 63);
+        set_dealed(i);
+    }
+    void set_dealed(size_t i)
+    {
+        uint64_t &w = dealed[i >> 6];
+        const uint64_t bit = (uint64_t)1 << (i & 63);
+        if(w & bit)
+            return;
+        w |= bit;
+        num_dealed++;
+        if(i == first_undealed)
+            first_undealed = next_undealed(i + 1);
+    }
+    // return index of the 1st arg not dealed from index i, args.size() if none.
+    size_t next_undealed(size_t i) const
+    {
+        if(i >= args.size())
+            return args.size();
+        size_t w = i >> 6;
+        uint64_t bits = ~dealed[w] & (~(uint64_t)0 << (i & 63));
+        while(!bits)
+        {
+            if(++w == dealed.size())
+                return args.size();
+            bits = ~dealed[w];
+        }
+        i = (w << 6) + count_trailing_zeros(bits);
+        return i < args.size() ? i : args.size();
+    }
+    // single '-' started multi chars, starts with non digit, e.g. "-abc".
+    static bool is_merged_short_flags(std::string_view arg)
+    {
+        return 3 <= arg.size() && arg[0] == '-' &&
+                arg[1] != '-' && arg[1] != '.' &&
+                !(arg[1] >= '0' && arg[1] <= '9');
+    }
+    // return "-c" for any char c, all in one contiguous static buffer,
+    // so that splitting merged short flags allocates nothing.
+    static std::string_view short_flag(char c)
+    {
+        static const struct Table
+        {
+            char str[512];
+            Table()
+            {
+                for(int i = 0; i < 256; i++)
+                {
+                    str[i * 2] = '-';
+                    str[i * 2 + 1] = (char)i;
+                }
+            }
+        } table;
+        return std::string_view(table.str + (uint8_t)c * 2, 2);
+    }
+    // response files loaded, tokens in args are views into them.
+    struct RspFile
+    {
+        char  *data;
+        size_t size;
+    };
+    std::pmr::vector<RspFile> rsp_files{&mem};
+    // push an arg at byte offset in its source.
+    void push_arg(std::string_view arg, size_t offset)
+    {
+        args.push_back(arg);
+#if(LOYOPTION_OBSERVER)
+        if(observer)
+        {
+            offsets.resize(args.size() - 1);
+            offsets.push_back(offset);
+            emit(OptionEvent::ArgTokenized, "OptionParser::OptionParser()", args.size() - 1);
+        }
+#else
+        (void)offset;
+#endif
+    }
+    // position of '=' in a "--name=value" arg, npos if not such an arg.
+    static size_t long_value_pos(std::string_view arg)
+    {
+        if(arg.size() < 4 || arg[0] != '-' || arg[1] != '-')
+            return std::string_view::npos;
+        return arg.find('=', 3);
+    }
+    // an arg split into args[first, first + num), as "-xyz" or "--name=value".
+    struct SplitArg
+    {
+        size_t first;
+        size_t num;
+        std::string_view arg;    // the arg before splitting.
+        bool merged;             // merged short flags, or "--name=value" if false.
+    };
+    std::pmr::vector<SplitArg> splits{&mem}; // sorted by first.
+    // return the split arg args[i] is split from, nullptr if none.
+    const SplitArg *split_of(size_t i) const
+    {
+        auto it = std::upper_bound(splits.begin(), splits.end(), i,
+                [](size_t i, const SplitArg &sp) { return i < sp.first; });
+        if(it == splits.begin() || i >= (it - 1)->first + (it - 1)->num)
+            return nullptr;
+        return &*(it - 1);
+    }
+    // return the split arg starting at args[i], if none of it's args is dealed, nullptr if not such one.
+    const SplitArg *unparsed_split(size_t i) const
+    {
+        const SplitArg *sp = split_of(i);
+        if(!sp || sp->first != i)
+            return nullptr;
+        for(size_t j = i; j < i + sp->num; j++)
+        {
+            if(is_dealed(j))
+                return nullptr;
+        }
+        return sp;
+    }
+    // the unparsed arg at args[i] not dealed, an arg split but not parsed at all is
+    // unparsed as a whole, such as an unsupported "--name=value" or "-xyz".
+    std::string_view unparsed_arg(size_t i) const
+    {
+        const SplitArg *sp = unparsed_split(i);
+        return sp ? sp->arg : args[i];
+    }
+    // return index of the unparsed arg next to the one at args[i], args.size() if none.
+    size_t next_unparsed(size_t i) const
+    {
+        const SplitArg *sp = unparsed_split(i);
+        return next_undealed(sp ? sp->first + sp->num : i + 1);
+    }
+    // add an arg at byte offset in its source, expand "@path" if rsp_depth > 0,
+    // split merged short flags into "-c"s, and "--name=value" into "--name" and "value", as views.
+    void add_arg(std::string_view arg, int rsp_depth, size_t offset)
+    {
+        if(rsp_depth > 0 && arg.size() > 1 && arg[0] == '@' &&
+                expand_rsp_file(std::pmr::string(arg.substr(1), &mem).c_str(), rsp_depth - 1))
+            return;
+        const size_t eq = long_value_pos(arg);
+        if(is_merged_short_flags(arg))
+        {
+            splits.push_back({args.size(), arg.size() - 1, arg, true});
+            for(size_t j = 1; j < arg.size(); j++)
+                push_arg(short_flag(arg[j]), offset + j);
+        }
+        else if(eq != std::string_view::npos)
+        {
+            splits.push_back({args.size(), 2, arg, false});
+            push_arg(arg.substr(0, eq), offset);
+            push_arg(arg.substr(eq + 1), offset + eq + 1);
+        }
+        else
+        {
+            push_arg(arg, offset);
+        }
+    }
+    // map the file (or read it when mmap is not available), and add its tokens as args.
+    //   * return : false if the file can not be read, "@path" will be kept as an arg.
+    bool expand_rsp_file(const char *path, int rsp_depth)
+    {
+        RspFile f{nullptr, 0};
+        if(!map_file(path, f))
+            return false;
+        if(!f.data)
+            return true;    // empty file
+        rsp_files.push_back(f);
+        char *p = f.data, *end = f.data + f.size;
+        std::string_view token;
+        while(next_rsp_token(p, end, token))
+            add_arg(token, rsp_depth, token.data() - f.data);
+        return true;
+    }
+    // map the file (or read it when mmap is not available) into f.
+    //   * return : false if the file can not be read, f.data is nullptr for an empty file.
+    static bool map_file(const char *path, RspFile &f)
+    {
+#if(LOYOPTION_MMAP)
+        int fd = open(path, O_RDONLY);
+        if(fd < 0)
+            return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if(ok && st.st_size > 0)
+        {   // private writable mapping, only pages with escapes or quotes get copied.
+            void *m = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ok = m != MAP_FAILED;
+            if(ok)
+                f = {(char *)m, (size_t)st.st_size};
+        }
+        close(fd);
+        if(!ok)
+            return false;
+#else
+        FILE *fp = fopen(path, "rb");
+        if(!fp)
+            return false;
+        fseek(fp, 0, SEEK_END);
+        long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        if(size > 0)
+        {
+            f = {new char[size], (size_t)size};
+            f.size = fread(f.data, 1, f.size, fp);
+        }
+        fclose(fp);
+#endif
+        return true;
+    }
+    static void unmap_file(const RspFile &f)
+    {
+#if(LOYOPTION_MMAP)
+        munmap(f.data, f.size);
+#else
+        delete[] f.data;
+#endif
+    }
+    static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    // get next token in [p, end), unescaped in place, and advance p,
+    // tokens are separated by spaces, "\ " is an escaped space,
+    // and "..." or '...' quotes a string with spaces or special chars.
+    //   * return : false if no more token.
+    static bool next_rsp_token(char *&p, char *end, std::string_view &token)
+    {
+        while(p < end && is_space(*p))
+            p++;
+        if(p == end)
+            return false;
+        char *w = p;    // write position, chars are only written when moved.
+        char *start = p;
+        auto put = [&w](char *from) { if(w != from) *w = *from; w++; };
+        while(p < end && !is_space(*p))
+        {
+            if(*p == '\\' && p + 1 < end)
+            {
+                put(p + 1);
+                p += 2;
+            }
+            else if(*p == '"' || *p == '\'')
+            {
+                const char q = *p++;
+                while(p < end && *p != q)
+                {
+                    if(q == '"' && *p == '\\' && p + 1 < end && (p[1] == '"' || p[1] == '\\'))
+                        p++;
+                    put(p++);
+                }
+                if(p < end)
+                    p++;    // closing quotation mark
+            }
+            else
+            {
+                put(p++);
+            }
+        }
+        token = std::string_view(start, w - start);
+        return true;
+    }
+    // load args from argv, into args and dealed with their capacity reused.
+    void load(int argc, const char **argv, int rsp_depth)
+    {
+        size_t num_args = 0;
+        for(int i = 0; i < argc; i++)
+        {
+            size_t arglen = strlen(argv[i]);
+            const std::string_view arg(argv[i], arglen);
+            num_args += is_merged_short_flags(arg) ? arglen - 1 :
+                        long_value_pos(arg) != std::string_view::npos ? 2 : 1;
+        }
+        args.reserve(num_args);
+        splits.clear();
+#if(LOYOPTION_OBSERVER)
+        offsets.clear();
+#endif
+        size_t offset = 0;
+        for(int i = 0; i < argc; i++)
+        {
+            add_arg(argv[i], i == 0 ? 0 : rsp_depth, offset);
+            offset += strlen(argv[i]) + 1;
+        }
+        dealed.assign((args.size() + 63) / 64, 0);
+        valued.assign(dealed.size(), 0);
+        set_dealed(0);  // exec name
+        get_exec_name();
+    }
+    void release_rsp_files()
+    {
+        for(const RspFile &f : rsp_files)
+            unmap_file(f);
+        rsp_files.clear();
+    }
+public:
+    // construct an instance by using argc and argv from main(),
+    // args are kept as views into argv, so argv must outlive the instance.
+    //   * rsp_depth : if > 0, expand "@path" args with tokens in response file "path",
+    //                 which can be nested in rsp_depth levels, 0 to disable.
+    //                 same quoting and escaping rules as command lines in shell apply in the file.
+    //   * resource  : memory_resource of all storage of the instance, MemoryScope::Current() if nullptr,
+    //                 see BytesUsed() for sizing an arena of it.
+    OptionParser(int argc, const char **argv, int rsp_depth = 0, std::pmr::memory_resource *resource = nullptr)
+        : mem(resource ? resource : MemoryScope::Current())
+    {
+        load(argc, argv, rsp_depth);
+    }
+    OptionParser(const OptionParser &) = delete;
+    OptionParser &operator=(const OptionParser &) = delete;
+private:
+    // construct a sub-parser of args of parent from index first on, for a subcommand,
+    // args are views into the same storage, so parent must outlive the instance,
+    // args dealed in parent stay dealed.
+    OptionParser(const OptionParser &parent, size_t first) : mem(parent.mem.Upstream())
+    {
+        args.assign(parent.args.begin() + first, parent.args.end());
+        for(const SplitArg &sp : parent.splits)
+        {
+            if(sp.first >= first)
+                splits.push_back({sp.first - first, sp.num, sp.arg, sp.merged});
+        }
+#if(LOYOPTION_OBSERVER)
+        observer = parent.observer;
+        observer_ctx = parent.observer_ctx;
+        if(first < parent.offsets.size())
+            offsets.assign(parent.offsets.begin() + first, parent.offsets.end());
+#endif
+        env_vars = parent.env_vars;
+        config_vars = parent.config_vars;
+        dealed.assign((args.size() + 63) / 64, 0);
+        valued.assign(dealed.size(), 0);
+        set_dealed(0);  // subcommand name
+        for(size_t i = 1; i < args.size(); i++)
+        {
+            if(parent.is_valued(first + i))
+                set_valued(i);
+            else if(parent.is_dealed(first + i))
+                set_dealed(i);
+        }
+        get_exec_name();
+    }
+public:
+    ~OptionParser()
+    {
+        release_rsp_files();
+        for(const RspFile &f : config_files)
+            unmap_file(f);
+    }
+#if(LOYOPTION_OBSERVER)
+    // set the observer of parsing events of this instance (and of it's subcommand parsers),
+    // nullptr to disable, ctx is passed to each call of fn,
+    // args are tokenized by the constructor with the default observer, Reparse() after it to
+    // observe tokenizing too.
+    void SetObserver(OptionObserver fn, void *ctx = nullptr)
+    {
+        observer = fn;
+        observer_ctx = ctx;
+    }
+    // set the default observer of instances constructed after it, nullptr to disable,
+    // set it before constructing any instance in any thread,
+    // initially it prints debug info with LOYOPTION_VERBOSE, or nullptr.
+    static void SetDefaultObserver(OptionObserver fn, void *ctx = nullptr)
+    {
+        default_observer = fn;
+        default_observer_ctx = ctx;
+    }
+#endif
+    // replace args with a new argc and argv, same as constructing a new instance,
+    // but reusing capacity of args and the name index of ParseAll(),
+    // so that once warmed up, Reparse() and ParseAll() allocate nothing
+    // (except for string values longer than ever and response files).
+    // options keep their values, Reset() them before parsing if needed, e.g.:
+    //   for(OptionBase *opt : opts) opt->Reset();
+    //   op.Reparse(argc, argv);
+    //   op.ParseAll(opts);
+    void Reparse(int argc, const char **argv, int rsp_depth = 0)
+    {
+        release_rsp_files();
+        args.clear();
+        num_dealed = 0;
+        first_undealed = 0;
+        load(argc, argv, rsp_depth);
+    }
+private:
+    // names and alt_names, id of an entry is the index in opts of ParseAll().
+    NameTrie name_index{&mem};
+    std::pmr::vector<NameTrie::Entry> name_entries{&mem};
+    std::pmr::vector<OptionBase *> indexed_opts{&mem};   // opts of name_index, kept for reusing it.
+    enum : uint8_t { NoMatch, Matched, AmbiguousMatch };
+    std::pmr::vector<uint8_t> matched{&mem};             // match state of opts[k] in ParseAll().
+    bool prefix_match = false;          // match "--" started names by unique prefix.
+    // is name_index built for opts with their current names ?
+    // an option may be destroyed and another one constructed at the same address with other names,
+    // so names are compared too, in O(total length of names).
+    bool name_index_of(const std::vector<OptionBase *> &opts) const
+    {
+        if(!std::equal(opts.begin(), opts.end(), indexed_opts.begin(), indexed_opts.end()) ||
+                (!opts.empty() && name_index.Empty()))
+            return false;
+        size_t e = 0;
+        for(size_t k = 0; k < opts.size(); k++)
+        {
+            if(e >= name_entries.size() || name_entries[e].id != k || name_entries[e].name != opts[k]->name)
+                return false;
+            e++;
+            if(!opts[k]->alt_name.empty() &&
+                    (e >= name_entries.size() || name_entries[e].id != k || name_entries[e].name != opts[k]->alt_name))
+                return false;
+            e += !opts[k]->alt_name.empty();
+        }
+        return e == name_entries.size();
+    }
+    // build name_index for opts, unless it's built for the same opts of the same names.
+    void build_name_index(const std::vector<OptionBase *> &opts)
+    {
+        if(name_index_of(opts))
+            return;
+        indexed_opts.assign(opts.begin(), opts.end());
+        name_entries.clear();
+        for(size_t k = 0; k < opts.size(); k++)
+        {
+            name_entries.push_back({opts[k]->name, k});
+            if(!opts[k]->alt_name.empty())
+                name_entries.push_back({opts[k]->alt_name, k});
+        }
+        name_index.Build(name_entries.data(), name_entries.size());
+    }
+    // update the opt whose name matched args[i],
+    // O is OptionBase, or Option<T> for calling its deal_value() directly.
+    //   * return : index of the last arg dealed.
+    template<typename O>
+    size_t deal_match(O &opt, size_t i, const char *where)
+    {
+        set_dealed(i);
+        opt.source = OptionBase::FromArgs;
+        emit(OptionEvent::OptionMatched, where, i, &opt);
+        if(opt.type == OptionBase::Bool)
+        {   // bool (no value)
+            opt.deal_value(std::string_view());
+            return i;
+        }
+        const OptionBase::Status prev = opt.status;
+        const SplitArg *sp = split_of(i);
+        if(sp && sp->merged && i + 1 < sp->first + sp->num)
+        {   // "-cVALUE", or "-abcVALUE" with bool "-a" and "-b", value is the rest chars.
+            const size_t last = sp->first + sp->num - 1;
+            for(size_t j = i + 1; j <= last; j++)
+                set_valued(j);
+            opt.deal_value(sp->arg.substr(i - sp->first + 2));
+            emit_value_status(opt, prev, where, i + 1);
+            return last;
+        }
+        if(i + 1 >= args.size())
+        {   // string and numeric, without value
+            opt.status = OptionBase::ValueNotFound;
+            emit(OptionEvent::ValueInvalid, where, i, &opt);
+            return i;
+        }
+        std::string_view value = args[i + 1];
+        size_t last = i + 1;
+        const SplitArg *vp = split_of(i + 1);
+        if(vp && vp->first == i + 1)
+        {   // a split arg as a whole is the value, such as "-abc" or "--name=value".
+            value = vp->arg;
+            last = vp->first + vp->num - 1;
+        }
+        for(size_t j = i + 1; j <= last; j++)
+            set_valued(j);
+        opt.deal_value(value);
+        emit_value_status(opt, prev, where, i + 1);
+        return last;
+    }
+    // a variable of the environment or a config file, for options not found in args.
+    struct SourceVar
+    {
+        std::string_view section;    // "[section]" of a config file, empty for environment.
+        std::string_view name;
+        std::string_view value;      // nullptr data for a name without '=' in a config file.
+        bool operator<(const SourceVar &v) const
+        {
+            return section != v.section ? section < v.section : name < v.name;
+        }
+    };
+    std::pmr::vector<SourceVar> env_vars{&mem};      // indexed by LoadEnv(), sorted, names without the prefix.
+    std::pmr::vector<SourceVar> config_vars{&mem};   // indexed by LoadConfig(), sorted.
+    std::pmr::vector<RspFile> config_files{&mem};    // config files loaded, kept by Reparse().
+    std::pmr::string env_name{&mem};     // scratch of environment variable name of an option.
+    static const SourceVar *find_var(const std::pmr::vector<SourceVar> &vars, std::string_view section, std::string_view name)
+    {
+        auto it = std::lower_bound(vars.begin(), vars.end(), SourceVar{section, name, {}});
+        return it != vars.end() && it->section == section && it->name == name ? &*it : nullptr;
+    }
+    // return the environment variable of an option name, nullptr if none.
+    const SourceVar *find_env(std::string_view name)
+    {
+        const size_t first = name.find_first_not_of('-');
+        if(first == std::string_view::npos)
+            return nullptr;
+        env_name.clear();
+        for(char c : name.substr(first))
+            env_name += c == '-' ? '_' : ('a' <= c && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+        return find_var(env_vars, {}, env_name);
+    }
+    // return the config variable of an option name, such as "int32_g" or "[net]" "port"
+    // for "--net.port", nullptr if none.
+    const SourceVar *find_config(std::string_view name) const
+    {
+        const size_t first = name.find_first_not_of('-');
+        if(first == std::string_view::npos)
+            return nullptr;
+        name.remove_prefix(first);
+        const SourceVar *var = find_var(config_vars, {}, name);
+        const size_t dot = name.find('.');
+        if(!var && dot != std::string_view::npos)
+            var = find_var(config_vars, name.substr(0, dot), name.substr(dot + 1));
+        return var;
+    }
+    // return the variable of opt's name or alt_name by find, and set matched_name.
+    template<typename Find>
+    static const SourceVar *find_names(OptionBase &opt, Find find)
+    {
+        if(const SourceVar *var = find(opt.name))
+        {
+            opt.matched_name = opt.name;
+            return var;
+        }
+        if(const SourceVar *var = find(opt.alt_name))
+        {
+            opt.matched_name = opt.alt_name;
+            return var;
+        }
+        return nullptr;
+    }
+    // update opt not found in args from its environment variable, or config variable, if any.
+    // an opt NameAmbiguous is not found by any arg either, it stays NameAmbiguous without a variable.
+    void deal_fallback(OptionBase &opt, const char *where)
+    {
+        if((opt.status != OptionBase::NotFound && opt.status != OptionBase::NameAmbiguous) ||
+                (env_vars.empty() && config_vars.empty()))
+            return;
+        OptionBase::Source source = OptionBase::FromEnv;
+        const SourceVar *var = find_names(opt, [this](std::string_view n) { return find_env(n); });
+        if(!var)
+        {
+            source = OptionBase::FromFile;
+            var = find_names(opt, [this](std::string_view n) { return find_config(n); });
+        }
+        if(!var)
+            return;
+        emit(OptionEvent::OptionMatched, where, SIZE_MAX, &opt);
+        opt.source = source;
+        opt.status = OptionBase::NotParsed;
+        const std::string_view v = var->value;
+        if(opt.type == OptionBase::Bool)
+            opt.deal_value(v);  // no value (nullptr data) for true, see parse_bool().
+        else if(!v.data())
+            opt.status = OptionBase::ValueNotFound;
+        else
+            opt.deal_value(v);
+        emit_value_status(opt, OptionBase::NotParsed, where, SIZE_MAX);
+    }
+    static std::string_view trim(std::string_view str)
+    {
+        while(!str.empty() && is_space(str.front()))
+            str.remove_prefix(1);
+        while(!str.empty() && is_space(str.back()))
+            str.remove_suffix(1);
+        return str;
+    }
+public:
+    // index environment variables whose names start with prefix, by a single scan of envp,
+    // then Parse() and ParseAll() update options not found in args from them,
+    // such as "LOYOPT_INT32_G=100" for "--int32_g" (or alt_name "-g" by "LOYOPT_G")
+    // with prefix "LOYOPT_", the name is upper cased, leading '-'s removed and other '-'s as '_'.
+    // values are parsed as in args, except that a bool option is true by "1", "true", "yes" or "on",
+    // false by "0", "false", "no", "off" or empty value (case insensitive), and ValueInvalid by others,
+    // and the option's GetSource() is FromEnv.
+    // values are views into envp, don't change the environment while parsing,
+    // the index is kept by Reparse().
+    //   * envp   : a nullptr terminated array of "name=value", environ by default.
+    //   * return : number of variables indexed.
+    size_t LoadEnv(std::string_view prefix, const char *const *envp = nullptr)
+    {
+        if(!envp)
+            envp = LOYOPTION_ENVIRON;
+        env_vars.clear();
+        for(; envp && *envp; envp++)
+        {
+            const std::string_view var = *envp;
+            if(var.size() <= prefix.size() || var.compare(0, prefix.size(), prefix) != 0)
+                continue;
+            const size_t eq = var.find('=', prefix.size());
+            if(eq == std::string_view::npos || eq == prefix.size())
+                continue;
+            env_vars.push_back({{}, var.substr(prefix.size(), eq - prefix.size()), var.substr(eq + 1)});
+        }
+        stable_sort_in_place(env_vars); // the first one of duplicated names wins.
+        return env_vars.size();
+    }
+    // index "name = value" lines of a config file by a single pass over it's memory-mapping,
+    // then Parse() and ParseAll() update options not found in args nor in environment from them,
+    // the name is the option's name or alt_name without leading '-', or the part after '.' in
+    // "[section]" before '.', such as "int32_g = 100" for "--int32_g" and "port = 80" after
+    // "[net]" for "--net.port", values are parsed as environment variables (see LoadEnv()),
+    // a bool option is true by a line of it's name without '=', and GetSource() is FromFile.
+    //   * in a line, spaces around name and value are ignored, a value can be quoted by "..."
+    //     or '...' to keep spaces, lines started with '#' or ';' are comments.
+    //   * the file is kept mapped until destruction, so names and values are not copied,
+    //     the index is kept by Reparse(), if a name repeats, the first one (in the first file
+    //     loaded) wins.
+    //   * return : false if the file can not be read.
+    bool LoadConfig(const std::string &path)
+    {
+        RspFile f{nullptr, 0};
+        if(!map_file(path.c_str(), f))
+            return false;
+        if(!f.data)
+            return true;    // empty file
+        config_files.push_back(f);
+        const char *p = f.data, *end = f.data + f.size;
+        std::string_view section;
+        while(p < end)
+        {
+            const char *eol = (const char *)memchr(p, '\n', end - p);
+            if(!eol)
+                eol = end;
+            const std::string_view line = trim(std::string_view(p, eol - p));
+            p = eol == end ? end : eol + 1;
+            if(line.empty() || line[0] == '#' || line[0] == ';')
+                continue;
+            if(line[0] == '[')
+            {
+                if(line.back() == ']')
+                    section = trim(line.substr(1, line.size() - 2));
+                continue;
+            }
+            const size_t eq = line.find('=');
+            std::string_view name = trim(line.substr(0, eq)), value;
+            name.remove_prefix(std::min(name.find_first_not_of('-'), name.size()));
+            if(eq != std::string_view::npos)
+            {
+                value = trim(line.substr(eq + 1));
+                if(value.size() >= 2 && (value[0] == '"' || value[0] == '\'') && value.back() == value[0])
+                    value = value.substr(1, value.size() - 2);
+                else if(value.empty())
+                    value = line.substr(line.size());   // empty but not nullptr.
+            }
+            if(!name.empty())
+                config_vars.push_back({section, name, value});
+        }
+        stable_sort_in_place(config_vars);
+        return true;
+    }
+    // return number of args (including exe name)
+    size_t NumArgs() const { return args.size(); }
+    // return total bytes allocated by the instance from it's memory_resource, such as
+    // indexes of args, environment and config files, the name index of ParseAll(),
+    // what a monotonic arena would have served for it (without alignment padding).
+    size_t BytesUsed() const { return mem.Allocated(); }
+    // return max bytes allocated and not deallocated at once.
+    size_t PeakBytesUsed() const { return mem.Peak(); }
+    // return ref of the executable name without path
+    const std::string &ExecName() const { return exec_name; }
+    // Parse args for the opt,
+    // an arg taken as value of an option by an earlier Parse() is never taken as an option name,
+    // such as "-a" and "-b" of "-cab" after Parse() of "-c" with value "ab".
+    //   * opt    : an instance of Option to be updated.
+    //   * return : status of the opt.
+    OptionBase::Status Parse(OptionBase &opt)
+    {
+        bool found = false;
+        opt.status = OptionBase::NotParsed;
+        opt.source = OptionBase::FromDefault;
+        for(size_t i = 0; i < args.size(); i++)
+        {
+            if(!is_valued(i) && opt.NameMatch(args[i]))
+            {
+                i = deal_match(opt, i, "OptionParser::Parse()");
+                found = true;
+                if(!opt.list)
+                    break;  // list option takes all occurrences.
+            }
+        }
+        if(!found)
+        {
+            opt.status = OptionBase::NotFound;
+            deal_fallback(opt, "OptionParser::Parse()");
+        }
+        emit(OptionEvent::OptionParsed, "OptionParser::Parse()", SIZE_MAX, &opt);
+        return opt.status;
+    }
+    // enable or disable matching a "--" started long name by it's unique prefix in ParseAll(),
+    // such as "--int" for "--int32_f", disabled by default, Parse() and OptionSet::ParseAll()
+    // always match names exactly, so enable it only for args parsed by ParseAll().
+    void SetPrefixMatch(bool enable) { prefix_match = enable; }
+    // Parse args for all the opts in a single pass over args,
+    // same results as calling Parse() for each of opts in order of their 1st occurrences in args,
+    // then for the others, except that
+    // a later occurrence of a list option taken as value of an option before it, isn't taken by the list
+    // (Parse() of a list option takes all of it's occurrences at once),
+    // with SetPrefixMatch(true), a "--" started arg matches the name it's a unique prefix of,
+    // and opts whose names an arg is an ambiguous prefix of, are NameAmbiguous if not found,
+    // opts not found (including NameAmbiguous ones) are updated from environment variables
+    // and config files, see LoadEnv() and LoadConfig().
+    //   * opts   : instances of Option to be updated.
+    //   * return : number of opts whose name exists in args.
+    size_t ParseAll(const std::vector<OptionBase *> &opts) { return parse_all(opts, nullptr); }
+private:
+    // an operand is an arg neither started with '-' nor split from one, such as a subcommand name.
+    bool is_operand(size_t i) const
+    {
+        return (args[i].empty() || args[i][0] != '-') && !split_of(i);
+    }
+    // ParseAll(), if operand isn't nullptr, stops at the 1st unparsed operand (such as the name of a
+    // subcommand) and sets it's index to *operand (args.size() if none), args from it on are left
+    // unparsed and no UnparsedArg events are emitted.
+    size_t parse_all(const std::vector<OptionBase *> &opts, size_t *operand)
+    {
+        build_name_index(opts);
+        matched.assign(opts.size(), NoMatch);
+        size_t num_matched = 0;
+        for(OptionBase *opt : opts)
+        {
+            opt->status = OptionBase::NotParsed;
+            opt->source = OptionBase::FromDefault;
+        }
+        if(operand)
+            *operand = args.size();
+        for(size_t i = first_undealed; i < args.size(); i = next_undealed(i + 1))
+        {
+            const std::string_view arg = args[i];
+            const bool is_long = arg.size() > 2 && arg[0] == '-' && arg[1] == '-';
+            const NameTrie::Result r = name_index.Lookup(arg, prefix_match && is_long);
+            if(r.match == NameTrie::Miss)
+            {
+                if(operand && is_operand(i))
+                {
+                    *operand = i;
+                    break;
+                }
+                continue;   // unsupported option, leave it unparsed.
+            }
+            if(r.match == NameTrie::Ambiguous)
+            {   // leave it unparsed.
+                for(size_t e = r.lo; e < r.hi; e++)
+                {
+                    uint8_t &m = matched[name_index.GetEntry(e).id];
+                    if(m == NoMatch)
+                        m = AmbiguousMatch;
+                }
+                continue;
+            }
+            const NameTrie::Entry &entry = name_index.GetEntry(r.entry);
+            OptionBase &opt = *opts[entry.id];
+            if(matched[entry.id] == Matched && !opt.list)
+                continue;   // repeated option, leave it unparsed.
+            num_matched += matched[entry.id] != Matched;
+            matched[entry.id] = Matched;
+            opt.matched_name = entry.name;
+            i = deal_match(opt, i, "OptionParser::ParseAll()");
+        }
+        for(size_t k = 0; k < opts.size(); k++)
+        {
+            if(matched[k] != Matched)
+                opts[k]->status = matched[k] == AmbiguousMatch ? OptionBase::NameAmbiguous : OptionBase::NotFound;
+            deal_fallback(*opts[k], "OptionParser::ParseAll()");
+            emit(OptionEvent::OptionParsed, "OptionParser::ParseAll()", SIZE_MAX, opts[k]);
+        }
+        if(!operand)
+            emit_unparsed("OptionParser::ParseAll()");
+        return num_matched;
+    }
+    // append names and alt_names of opts starting with partial, or value names of the option
+    // named prev (or before '=' in partial), one per line.
+    static void append_completions(std::string &buf, const std::vector<OptionBase *> &opts,
+            std::string_view prev, std::string_view partial)
+    {
+        std::vector<NameTrie::Entry> entries;
+        entries.reserve(opts.size() * 2);
+        for(size_t k = 0; k < opts.size(); k++)
+        {
+            entries.push_back({opts[k]->name, k});
+            if(!opts[k]->alt_name.empty() && opts[k]->alt_name != opts[k]->name)
+                entries.push_back({opts[k]->alt_name, k});
+        }
+        NameTrie trie;
+        trie.Build(entries);
+        // the option named name, or a unique prefix of it for a "--" started name.
+        auto find = [&](std::string_view name) -> const OptionBase *
+        {
+            const bool is_long = name.size() > 2 && name[0] == '-' && name[1] == '-';
+            const NameTrie::Result r = trie.Lookup(name, is_long);
+            return r.match == NameTrie::Exact || r.match == NameTrie::Prefix ?
+                    opts[trie.GetEntry(r.entry).id] : nullptr;
+        };
+        auto append_values = [&](const OptionBase &opt, std::string_view before, std::string_view value)
+        {
+            for(size_t i = 0; i < opt.num_value_names(); i++)
+            {
+                const std::string_view v = opt.value_name(i);
+                if(v.substr(0, value.size()) == value)
+                    buf.append(before).append(v).append(1, '\n');
+            }
+        };
+        const size_t eq = long_value_pos(partial);
+        if(eq != std::string_view::npos)
+        {   // "--name=value"
+            if(const OptionBase *opt = find(partial.substr(0, eq)))
+                append_values(*opt, partial.substr(0, eq + 1), partial.substr(eq + 1));
+            return;
+        }
+        const OptionBase *opt = prev.empty() ? nullptr : find(prev);
+        if(opt && opt->type != OptionBase::Bool)
+        {   // a value, nothing for a string or numeric option, left to the shell.
+            append_values(*opt, std::string_view(), partial);
+            return;
+        }
+        const NameTrie::Result r = trie.Lookup(partial, true);
+        if(r.match == NameTrie::Miss)
+            return;
+        for(size_t e = r.lo; e < r.hi; e++)
+            buf.append(trie.GetEntry(e).name).append(1, '\n');
+    }
+    // append the completion script of shell for the executable exec, false if shell is unknown.
+    static bool append_completion_script(std::string &buf, std::string_view exec, std::string_view shell)
+    {
+        static const char bash[] =
+            "_@FUNC@()\n"
+            "{\n"
+            "    local IFS=$'\\n'\n"
+            "    COMPREPLY=($(\"${COMP_WORDS[0]}\" --complete \"${COMP_WORDS[@]:1:COMP_CWORD}\" 2>/dev/null))\n"
+            "    if [ ${#COMPREPLY[@]} -eq 0 ]; then\n"
+            "        COMPREPLY=($(compgen -f -- \"${COMP_WORDS[COMP_CWORD]}\"))\n"
+            "    fi\n"
+            "}\n"
+            "complete -F _@FUNC@ @PROG@\n";
+        static const char zsh[] =
+            "#compdef @PROG@\n"
+            "_@FUNC@()\n"
+            "{\n"
+            "    local -a candidates\n"
+            "    candidates=(\"${(@f)$(\"${words[1]}\" --complete \"${(@)words[2,CURRENT]}\" 2>/dev/null)}\")\n"
+            "    candidates=(${candidates:#})\n"
+            "    if (( ${#candidates} )); then\n"
+            "        compadd -a candidates\n"
+            "    else\n"
+            "        _files\n"
+            "    fi\n"
+            "}\n"
+            "compdef _@FUNC@ @PROG@\n";
+        static const char fish[] =
+            "function __@FUNC@\n"
+            "    set -l tokens (commandline -opc)\n"
+            "    set -l current (commandline -ct)\n"
+            "    set -l candidates ($tokens[1] --complete $tokens[2..-1] \"$current\" 2>/dev/null)\n"
+            "    if test (count $candidates) -gt 0\n"
+            "        printf '%s\\n' $candidates\n"
+            "    else\n"
+            "        __fish_complete_path \"$current\"\n"
+            "    end\n"
+            "end\n"
+            "complete -c @PROG@ -f -a '(__@FUNC@)'\n";
+        const char *script = shell == "bash" ? bash : shell == "zsh" ? zsh : shell == "fish" ? fish : nullptr;
+        if(!script)
+            return false;
+        const size_t pos = exec.find_last_of("/\\");
+        const std::string_view prog = exec.substr(pos == std::string_view::npos ? 0 : pos + 1);
+        std::string func(prog);
+        for(char &c : func)
+        {
+            if(!(('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9')))
+                c = '_';
+        }
+        func += "_complete";
+        for(const char *p = script; *p;)
+        {
+            if(*p == '@' && strncmp(p, "@FUNC@", 6) == 0)
+            {
+                buf.append(func);
+                p += 6;
+            }
+            else if(*p == '@' && strncmp(p, "@PROG@", 6) == 0)
+            {
+                buf.append(prog);
+                p += 6;
+            }
+            else
+                buf.append(1, *p++);
+        }
+        return true;
+    }
+public:
+    // answer a shell completion request without parsing any option, call it at the beginning
+    // of main() before constructing an OptionParser, e.g.:
+    //   if(OptionParser::Complete(argc, argv, options))
+    //       return 0;
+    //   * "prog --complete [words...] partial" : print names and alt_names of opts starting with
+    //     partial (the word being completed, may be empty), one per line, or names of choices if
+    //     the word before partial is a choice option's name (or partial is "--name=..."),
+    //     nothing after name of other non-bool options, so that the shell completes file names.
+    //   * "prog --complete-script bash|zsh|fish" : print a completion script calling
+    //     "prog --complete", such as `source <(prog --complete-script bash)` in ~/.bashrc.
+    //   * out    : where candidates or the script are written to.
+    //   * return : false if argv is not a completion request, nothing is printed.
+    static bool Complete(int argc, const char **argv, const std::vector<OptionBase *> &opts, FILE *out = stdout)
+    {
+        if(argc < 2)
+            return false;
+        const std::string_view cmd = argv[1];
+        std::string buf;
+        if(cmd == "--complete")
+            append_completions(buf, opts, argc > 3 ? argv[argc - 2] : "", argc > 2 ? argv[argc - 1] : "");
+        else if(cmd == "--complete-script")
+            append_completion_script(buf, argv[0], argc > 2 ? argv[2] : "");
+        else
+            return false;
+        fwrite(buf.data(), 1, buf.size(), out);
+        return true;
+    }
+    // FirstUnparedArg returns the 1st unparsed arg.
+    // after parsed for all options, this will be
+    // the 1st unrecognised option or duplicated option.
+    // an arg split into args (merged short flags, or "--name=value") but not parsed at all
+    // is unparsed as the original arg, such as "--unknown=1", instead of "--unknown" and "1".
+    std::string_view FirstUnparsedArg() const
+    {
+        return first_undealed < args.size() ? unparsed_arg(first_undealed) : std::string_view();
+    }
+    // return number of unparsed args, each split arg not parsed at all counted once.
+    size_t NumUnparsedArgs() const
+    {
+        size_t num = args.size() - num_dealed;
+        for(const SplitArg &sp : splits)
+            num -= unparsed_split(sp.first) ? sp.num - 1 : 0;
+        return num;
+    }
+    // iterator over unparsed args, skipping parsed ones by scanning the bitset.
+    class UnparsedIterator
+    {
+        const OptionParser *op;
+        size_t i;
+    public:
+        UnparsedIterator(const OptionParser *op, size_t i) : op(op), i(i) {}
+        std::string_view operator*() const { return op->unparsed_arg(i); }
+        UnparsedIterator &operator++() { i = op->next_unparsed(i); return *this; }
+        bool operator==(const UnparsedIterator &other) const { return i == other.i; }
+        bool operator!=(const UnparsedIterator &other) const { return i != other.i; }
+        // index of the arg in all args, of the 1st one for a split arg unparsed as a whole.
+        size_t Index() const { return i; }
+    };
+    struct UnparsedRange
+    {
+        UnparsedIterator b, e;
+        UnparsedIterator begin() const { return b; }
+        UnparsedIterator end() const { return e; }
+    };
+    // UnparsedArgs returns a range of all unparsed args, without allocating,
+    // e.g. for(string_view a : op.UnparsedArgs()) { ... }.
+    // parsing more options invalidates the range.
+    UnparsedRange UnparsedArgs() const
+    {
+        return { UnparsedIterator(this, first_undealed), UnparsedIterator(this, args.size()) };
     }
     // GetAllUnparsedArgs returns all unparsed args.
     // after parsed for all options, these args will be
     // all the unrecognised option or duplicated option.
-    vector<string> GetAllUnparsedArgs() const
+    std::vector<std::string> GetAllUnparsedArgs() const
     {
-        vector<string> rtn;
-        for(const Arg &a : args)
-            if(!a.first)
-                rtn.push_back(a.second);
+        std::vector<std::string> rtn;
+        rtn.reserve(NumUnparsedArgs());
+        for(std::string_view a : UnparsedArgs())
+            rtn.emplace_back(a);
         return rtn;
     }
 };
 
+// OptionStream: parse options incrementally from input arriving in chunks, such as a pipe
+// or a socket, without holding the whole input, for long-lived workers receiving job options.
+// input is tokenized as a response file (see OptionParser), with quoting and escaping state
+// kept across chunks, each token is matched as soon as it's completed, same as ParseAll(),
+// so parsing overlaps with reading, and memory is bounded by the largest token.
+// e.g.:
+//   OptionStream os(options);
+//   while((n = read(fd, buf, sizeof(buf))) > 0)   // or os.ParseFd(fd), os.ParseFrom(read).
+//       os.Feed(buf, n);
+//   os.Finish();
+// options not found are not updated from environment variables or config files.
+class OptionStream
+{
+    enum State : uint8_t
+    {
+        Space,          // between tokens.
+        Plain,          // in a token, out of quotation marks.
+        Escape,         // after '\' out of quotation marks.
+        Double,         // in "...".
+        DoubleEscape,   // after '\' in "...".
+        Single          // in '...'.
+    };
+    std::vector<OptionBase *> opts;
+    NameTrie name_index;
+    std::vector<uint8_t> matched;            // match state of opts[k], as OptionParser::matched.
+    std::pmr::string token{MemoryScope::Current()};      // the token not completed yet.
+    std::pmr::string first_unparsed{MemoryScope::Current()};
+    OptionBase *pending = nullptr;      // the option waiting for it's value in the next token.
+    State state = Space;
+    bool prefix_match = false;
+    size_t num_matched = 0;
+    size_t num_tokens = 0;
+    size_t num_unparsed = 0;
+    using UnparsedHandler = void (*)(std::string_view arg, void *ctx);
+    UnparsedHandler on_unparsed = nullptr;
+    void *unparsed_ctx = nullptr;
+    void unparsed(std::string_view arg)
+    {
+        if(num_unparsed++ == 0)
+            first_unparsed.assign(arg.data(), arg.size());
+        if(on_unparsed)
+            on_unparsed(arg, unparsed_ctx);
+    }
+    // the option named name, marked as matched, nullptr if none or repeated.
+    OptionBase *match(std::string_view name)
+    {
+        const bool is_long = name.size() > 2 && name[0] == '-' && name[1] == '-';
+        const NameTrie::Result r = name_index.Lookup(name, prefix_match && is_long);
+        if(r.match == NameTrie::Miss)
+            return nullptr;
+        if(r.match == NameTrie::Ambiguous)
+        {
+            for(size_t e = r.lo; e < r.hi; e++)
+            {
+                uint8_t &m = matched[name_index.GetEntry(e).id];
+                if(m == OptionParser::NoMatch)
+                    m = OptionParser::AmbiguousMatch;
+            }
+            return nullptr;
+        }
+        const NameTrie::Entry &entry = name_index.GetEntry(r.entry);
+        OptionBase &opt = *opts[entry.id];
+        if(matched[entry.id] == OptionParser::Matched && !opt.list)
+            return nullptr;     // repeated option
+        num_matched += matched[entry.id] != OptionParser::Matched;
+        matched[entry.id] = OptionParser::Matched;
+        opt.matched_name = entry.name;
+        opt.source = OptionBase::FromArgs;
+        return &opt;
+    }
+    // deal a completed token, as an arg of OptionParser::ParseAll().
+    void deal_token(std::string_view t)
+    {
+        if(pending)
+        {   // a token taken as value is never taken as an option name.
+            OptionBase &opt = *pending;
+            pending = nullptr;
+            opt.deal_value(t);
+            return;
+        }
+        if(OptionParser::is_merged_short_flags(t))
+        {   // "-abc", or "-abVALUE" with bool "-a" and non-bool "-b",
+            // leading flags not matched are unparsed once one matches, or as t if none does.
+            size_t num_leading = 0;
+            for(size_t j = 1; j < t.size(); j++)
+            {
+                const std::string_view flag = OptionParser::short_flag(t[j]);
+                OptionBase *opt = match(flag);
+                if(!opt && num_leading + 1 == j)
+                {
+                    num_leading++;
+                    continue;
+                }
+                for(; num_leading; num_leading--)
+                    unparsed(OptionParser::short_flag(t[j - num_leading]));
+                if(!opt)
+                    unparsed(flag);
+                else if(opt->type == OptionBase::Bool)
+                    opt->deal_value(std::string_view());
+                else if(j + 1 < t.size())
+                    return opt->deal_value(t.substr(j + 1));
+                else
+                    pending = opt;
+            }
+            if(num_leading)
+                unparsed(t);
+            return;
+        }
+        const size_t eq = OptionParser::long_value_pos(t);
+        OptionBase *opt = match(eq == std::string_view::npos ? t : t.substr(0, eq));
+        if(!opt)
+            return unparsed(t);
+        if(opt->type == OptionBase::Bool)
+        {   // "--flag=x" is "--flag" and "x".
+            opt->deal_value(std::string_view());
+            if(eq != std::string_view::npos)
+                deal_token(t.substr(eq + 1));
+        }
+        else if(eq != std::string_view::npos)
+            opt->deal_value(t.substr(eq + 1));
+        else
+            pending = opt;
+    }
+    void end_token()
+    {
+        num_tokens++;
+        deal_token(std::string_view(token.data(), token.size()));
+        token.clear();
+        state = Space;
+    }
+public:
+    // parse into opts, names of an option never change after constructed.
+    OptionStream(const std::vector<OptionBase *> &opts) : opts(opts), name_index(MemoryScope::Current())
+    {
+        std::vector<NameTrie::Entry> entries;
+        entries.reserve(opts.size() * 2);
+        for(size_t k = 0; k < opts.size(); k++)
+        {
+            entries.push_back({opts[k]->name, k});
+            if(!opts[k]->alt_name.empty())
+                entries.push_back({opts[k]->alt_name, k});
+        }
+        name_index.Build(entries);
+        Begin();
+    }
+    OptionStream(const OptionStream &) = delete;
+    OptionStream &operator=(const OptionStream &) = delete;
+    // start a new input, such as the next job, opts keep their values, Reset() them if needed.
+    void Begin()
+    {
+        matched.assign(opts.size(), OptionParser::NoMatch);
+        for(OptionBase *opt : opts)
+        {
+            opt->status = OptionBase::NotParsed;
+            opt->source = OptionBase::FromDefault;
+        }
+        token.clear();
+        first_unparsed.clear();
+        pending = nullptr;
+        state = Space;
+        num_matched = num_tokens = num_unparsed = 0;
+    }
+    // enable or disable matching a "--" started long name by it's unique prefix, as
+    // OptionParser::SetPrefixMatch(), disabled by default.
+    void SetPrefixMatch(bool enable) { prefix_match = enable; }
+    // call fn with each unparsed arg and ctx, such as an unsupported or repeated option,
+    // arg is valid only during the call.
+    void SetUnparsedHandler(UnparsedHandler fn, void *ctx = nullptr)
+    {
+        on_unparsed = fn;
+        unparsed_ctx = ctx;
+    }
+    // consume the next chunk [data, data + size) of input, a token may span chunks.
+    void Feed(const char *data, size_t size)
+    {
+        const char *p = data, *const end = data + size;
+        while(p < end)
+        {
+            const char *q = p;
+            switch(state)
+            {
+            case Space:
+                while(q < end && OptionParser::is_space(*q))
+                    q++;
+                p = q;
+                if(p < end)
+                    state = Plain;
+                break;
+            case Plain:
+                while(q < end && !OptionParser::is_space(*q) && *q != '\\' && *q != '"' && *q != '\'')
+                    q++;
+                token.append(p, q);
+                p = q;
+                if(p == end)
+                    break;
+                if(OptionParser::is_space(*p))
+                    end_token();
+                else
+                    state = *p == '\\' ? Escape : *p == '"' ? Double : Single;
+                p++;
+                break;
+            case Escape:
+                token.push_back(*p++);
+                state = Plain;
+                break;
+            case Double:
+                while(q < end && *q != '"' && *q != '\\')
+                    q++;
+                token.append(p, q);
+                p = q;
+                if(p == end)
+                    break;
+                state = *p == '"' ? Plain : DoubleEscape;
+                p++;
+                break;
+            case DoubleEscape:
+                // only \" and \\ are escapes in "...".
+                if(*p != '"' && *p != '\\')
+                    token.push_back('\\');
+                token.push_back(*p++);
+                state = Double;
+                break;
+            case Single:
+                q = (const char *)memchr(p, '\'', end - p);
+                q = q ? q : end;
+                token.append(p, q);
+                p = q;
+                if(p < end)
+                {
+                    state = Plain;
+                    p++;
+                }
+                break;
+            }
+        }
+    }
+    // end of input, complete the last token, an option still waiting for it's value is
+    // ValueNotFound, options not found are NotFound or NameAmbiguous.
+    //   * return : number of opts whose name exists in input.
+    size_t Finish()
+    {
+        if(state == Escape || state == DoubleEscape)
+            token.push_back('\\');  // a trailing '\' is kept.
+        if(state != Space)
+            end_token();
+        if(pending)
+        {
+            pending->status = OptionBase::ValueNotFound;
+            pending = nullptr;
+        }
+        for(size_t k = 0; k < opts.size(); k++)
+        {
+            if(matched[k] != OptionParser::Matched)
+            {
+                opts[k]->status = matched[k] == OptionParser::AmbiguousMatch ?
+                        OptionBase::NameAmbiguous : OptionBase::NotFound;
+            }
+        }
+        return num_matched;
+    }
+    // Feed() all chunks read by read(buf, size), until it returns 0 (or negative) at
+    // the end of input, then Finish(), chunks are read into a buffer on stack.
+    template<typename Read>
+    size_t ParseFrom(Read &&read)
+    {
+        char buf[4096];
+        for(;;)
+        {
+            const auto n = read(buf, sizeof(buf));
+            if(n <= 0)
+                break;
+            Feed(buf, (size_t)n);
+        }
+        return Finish();
+    }
+#if(LOYOPTION_MMAP)
+    // ParseFrom() read() of fd, until the end of input or an error.
+    size_t ParseFd(int fd)
+    {
+        return ParseFrom([fd](char *buf, size_t size)
+        {
+            ssize_t n;
+            do
+                n = ::read(fd, buf, size);
+            while(n < 0 && errno == EINTR);
+            return n;
+        });
+    }
+#endif
+    // number of tokens completed.
+    size_t NumTokens() const { return num_tokens; }
+    // number of unparsed args, merged short flags not matched count one each.
+    size_t NumUnparsedArgs() const { return num_unparsed; }
+    // the 1st unparsed arg, such as an unsupported or repeated option.
+    std::string_view FirstUnparsedArg() const { return std::string_view(first_unparsed.data(), first_unparsed.size()); }
+    // bytes held by the token buffer, which is bounded by the largest token.
+    size_t TokenCapacity() const { return token.capacity(); }
+};
+
+// Command: a subcommand of a CommandSet, such as "ingest" of "tool ingest -f a.txt".
+//   * name    : name of the subcommand.
+//   * main    : called with a parser of args from the subcommand name on,
+//               constructs options of the subcommand and parses them, return an exit code.
+//   * summary : one line help info of the subcommand.
+struct Command
+{
+    std::string_view name;
+    int (*main)(OptionParser &op);
+    std::string_view summary;
+};
+
+// CommandSet: dispatches to a subcommand by the 1st operand (an arg not started with '-'), so that
+// only options of the subcommand used are constructed (e.g. as locals of its main) and parsed,
+// global options are parsed only in args before the subcommand name.
+// e.g.:
+//   static int ingest_main(OptionParser &op)
+//   {
+//       Option<string> opt_file("", "-f", "--file");
+//       vector<OptionBase *> options{ &opt_file };
+//       op.ParseAll(options);
+//       ...
+//   }
+//   static const CommandSet commands
+//   {
+//       { "ingest" , &ingest_main , "ingest data files." },
+//       { "compact", &compact_main, "compact the database." }
+//   };
+//   int main(int argc, const char *argv[])
+//   {
+//       OptionParser op(argc, argv);
+//       int rtn;
+//       if(!commands.Dispatch(op, global_options, rtn))
+//           ...   // no or unknown subcommand
+//       return rtn;
+//   }
+class CommandSet
+{
+    std::vector<Command> cmds;
+public:
+    CommandSet(std::initializer_list<Command> cmds) : cmds(cmds) {}
+    // return the command named name, nullptr if not found.
+    const Command *Find(std::string_view name) const
+    {
+        for(const Command &cmd : cmds)
+        {
+            if(cmd.name == name)
+                return &cmd;
+        }
+        return nullptr;
+    }
+    // parse global_opts in args of op before the 1st operand (an arg neither started with '-'
+    // nor taken as a value), then call main of the command named by the operand,
+    // with a parser of args from the command name on, which are all marked parsed in op,
+    // so an option of the command named same as a global one (e.g. "-f") is parsed by the command.
+    //   * rtn    : return value of main of the command, unchanged if no command dispatched.
+    //   * return : the command dispatched, nullptr if no operand or it's not a command.
+    const Command *Dispatch(OptionParser &op, const std::vector<OptionBase *> &global_opts, int &rtn) const
+    {
+        size_t first;
+        op.parse_all(global_opts, &first);
+        return dispatch(op, first, rtn);
+    }
+    // same as Dispatch() above without global options, args parsed in op before
+    // (by Parse() or ParseAll()) are also parsed in the parser of the command.
+    const Command *Dispatch(OptionParser &op, int &rtn) const
+    {
+        size_t first = op.first_undealed;
+        while(first < op.args.size() && !op.is_operand(first))
+            first = op.next_undealed(first + 1);
+        return dispatch(op, first, rtn);
+    }
+private:
+    const Command *dispatch(OptionParser &op, size_t first, int &rtn) const
+    {
+        const Command *cmd = first < op.args.size() ? Find(op.args[first]) : nullptr;
+        if(!cmd)
+        {
+            op.emit_unparsed("CommandSet::Dispatch()");
+            return nullptr;
+        }
+        OptionParser sub(op, first);
+        for(size_t i = first; i < op.args.size(); i = op.next_undealed(i + 1))
+            op.set_dealed(i);
+        op.emit_unparsed("CommandSet::Dispatch()");
+        rtn = cmd->main(sub);
+        return cmd;
+    }
+public:
+    // append a help line of each command to buf, such as "    ingest : ingest data files.".
+    void AppendHelpTo(std::string &buf) const
+    {
+        size_t width = 0;
+        for(const Command &cmd : cmds)
+            width = std::max(width, cmd.name.size());
+        for(const Command &cmd : cmds)
+        {
+            buf.append("    ").append(cmd.name).append(width - cmd.name.size(), ' ');
+            buf.append(" : ").append(cmd.summary).append(1, '\n');
+        }
+    }
+    const std::vector<Command> &All() const { return cmds; }
+};
+
+// Opt: compile-time definition of an option in an OptionSet.
+//   * T       : value type, same as Option<T>.
+//   * Name    : name of the option, a constexpr char array with static storage,
+//               such as `static constexpr char g_name[] = "-g";`.
+//   * AltName : alterative name of the option, nullptr for none.
+template<typename T, const char *Name, const char *AltName = nullptr>
+struct Opt
+{
+    using type = T;
+    static constexpr std::string_view name = Name;
+    static constexpr std::string_view alt_name = AltName ? std::string_view(AltName) : std::string_view();
+};
+
+// OptionSet: a set of options all defined at compile time by Opt<>s,
+// looks up names in args by a constexpr perfect hash table,
+// one hash and one compare per arg, and parses each option with its value type known
+// at compile time, through a table of parse functions instantiated for each type.
+// e.g.:
+//   static constexpr char g_name[] = "-g", g_alt[] = "--int32_g", a_name[] = "-a";
+//   OptionSet<Opt<int32_t, g_name, g_alt>, Opt<bool, a_name>> opts
+//   {
+//       make_tuple(50, 0, 100), // args of Option<int32_t> constructor, without names.
+//       make_tuple()            // args of Option<bool> constructor, without names.
+//   };
+//   opts.ParseAll(op);
+//   int32_t g = opts.Get<0>().Value();
+template<typename... Opts>
+class OptionSet
+{
+    static_assert(sizeof...(Opts) > 0, "OptionSet needs at least one Opt.");
+    static_assert(sizeof...(Opts) * 2 < 0xffff, "too many options in an OptionSet.");
+    static constexpr size_t num_opts = sizeof...(Opts);
+public:
+    template<size_t I>
+    using ValueType = std::tuple_element_t<I, std::tuple<typename Opts::type...>>;
+private:
+    // names[k] is name of the k-th option, names[num_opts + k] is its alt_name.
+    static constexpr std::string_view names[num_opts * 2] = { Opts::name..., Opts::alt_name... };
+    static constexpr PerfectHash<num_opts * 2> table{names};
+    static_assert(table.IsUnique(), "names and alt_names in an OptionSet must be unique.");
+    // return 1 + index in names[] of the str, 0 if not a name.
+    static size_t lookup(std::string_view str) { return table.Find(names, str); }
+    template<size_t I>
+    struct Elem
+    {
+        Option<ValueType<I>> opt;
+        template<typename Init, size_t... J>
+        Elem(Init &&init, std::index_sequence<J...>)
+            : opt(std::get<J>(std::forward<Init>(init))..., names[I], names[num_opts + I]) {}
+        template<typename Init>
+        Elem(Init &&init) : Elem(std::forward<Init>(init), std::make_index_sequence<std::tuple_size_v<std::decay_t<Init>>>()) {}
+    };
+    template<typename Seq> struct Elems;
+    template<size_t... I>
+    struct Elems<std::index_sequence<I...>> : Elem<I>...
+    {
+        template<typename... Inits>
+        Elems(Inits &&...inits) : Elem<I>(std::forward<Inits>(inits))... {}
+    };
+    Elems<std::make_index_sequence<num_opts>> elems;
+
+    // parse an option of value type T, whose name or alt_name matched args[i] of op.
+    template<typename T>
+    static size_t deal(OptionParser &op, OptionBase &opt, bool alt, size_t i)
+    {
+        opt.matched_name = alt ? opt.alt_name : opt.name;
+        return op.deal_match(static_cast<Option<T> &>(opt), i, "OptionSet::ParseAll()");
+    }
+    using Deal = size_t (*)(OptionParser &, OptionBase &, bool, size_t);
+    static constexpr Deal deals[num_opts] = { &deal<typename Opts::type>... };
+    template<size_t... I>
+    std::array<OptionBase *, num_opts> all(std::index_sequence<I...>) { return { &Get<I>()... }; }
+public:
+    // construct all options of the set.
+    //   * inits : a tuple for each Opt, args of its Option<T> constructor without the names.
+    template<typename... Inits, typename = std::enable_if_t<sizeof...(Inits) == num_opts>>
+    OptionSet(Inits &&...inits) : elems(std::forward<Inits>(inits)...) {}
+    OptionSet(const OptionSet &) = delete;
+    // return ref of the I-th option.
+    template<size_t I>
+    Option<ValueType<I>> &Get() { return static_cast<Elem<I> &>(elems).opt; }
+    template<size_t I>
+    const Option<ValueType<I>> &Get() const { return static_cast<const Elem<I> &>(elems).opt; }
+    // return pointers to all options, e.g. for iterating over their status or help.
+    std::array<OptionBase *, num_opts> All() { return all(std::make_index_sequence<num_opts>()); }
+    // Parse args of op for all options in a single pass,
+    // same as OptionParser::ParseAll().
+    //   * return : number of options whose name exists in args.
+    size_t ParseAll(OptionParser &op)
+    {
+        std::array<OptionBase *, num_opts> opts = All();
+        bool matched[num_opts] = {};
+        size_t num_matched = 0;
+        for(OptionBase *opt : opts)
+        {
+            opt->status = OptionBase::NotParsed;
+            opt->source = OptionBase::FromDefault;
+        }
+        for(size_t i = op.first_undealed; i < op.args.size(); i = op.next_undealed(i + 1))
+        {
+            const size_t e = lookup(op.args[i]);
+            if(e == 0)
+                continue;   // unsupported option, leave it unparsed.
+            const size_t k = (e - 1) % num_opts;
+            if(matched[k] && !opts[k]->list)
+                continue;   // repeated option, leave it unparsed.
+            num_matched += !matched[k];
+            matched[k] = true;
+            i = deals[k](op, *opts[k], e - 1 >= num_opts, i);
+        }
+        for(size_t k = 0; k < num_opts; k++)
+        {
+            if(!matched[k])
+                opts[k]->status = OptionBase::NotFound;
+            op.deal_fallback(*opts[k], "OptionSet::ParseAll()");
+            op.emit(OptionEvent::OptionParsed, "OptionSet::ParseAll()", SIZE_MAX, opts[k]);
+        }
+        op.emit_unparsed("OptionSet::ParseAll()");
+        return num_matched;
+    }
+};
+
+// OptionBlob: a compact, versioned binary blob of parsed state of options, values, status and
+// matched names, for passing parsed options to worker processes without re-parsing args.
+//   * layout  : a 28 bytes header, "LOYB", version, byte order mark, number of options,
+//               size of the blob (64 bits) and a schema hash, then a record for each option,
+//               type tag, status, matched name, source, size of value (64 bits) and raw bytes
+//               of value, so a value or a blob may be larger than 4GB,
+//               all in host byte order, a blob is for processes on the same machine.
+//   * schema  : hash of type, list flag, base, unit, name and alt_name of options in order,
+//               Load() refuses a blob saved by options defined differently.
+//   * passing : by a pipe / fd or shared memory as it is, Load() reads a string_view of
+//               a memory-mapped blob in place, or by an environment variable via ToText().
+// e.g.:
+//   string blob = OptionBlob::Save(options);          // in the supervisor, after ParseAll().
+//   setenv("MY_OPTS", OptionBlob::ToText(blob).c_str(), 1);
+//   OptionBlob::FromText(getenv("MY_OPTS"), blob);     // in a worker, with the same options.
+//   if(OptionBlob::Load(options, blob) != OptionBlob::Loaded) ...
+class OptionBlob
+{
+public:
+    static constexpr uint16_t version = 2;    // 2 : sizes of 64 bits.
+    enum LoadResult
+    {
+        Loaded         , // values and status of all options are loaded.
+        BlobInvalid    , // not a blob, truncated, or any record is malformed.
+        VersionMismatch, // saved by another version of OptionBlob, or in another byte order.
+        SchemaMismatch   // saved by options with other definitions.
+    };
+private:
+    static constexpr std::string_view magic = "LOYB";
+    static constexpr uint16_t byte_order = 0x0102;
+    static constexpr size_t header_size = 28;   // magic, version, byte_order, num, size, schema.
+    static constexpr size_t record_size = 12;   // type, status, matched, source, size of value.
+    // FNV-1a
+    static void hash(uint64_t &h, const void *data, size_t size)
+    {
+        for(size_t i = 0; i < size; i++)
+        {
+            h ^= ((const uint8_t *)data)[i];
+            h *= 1099511628211ull;
+        }
+    }
+    static void hash(uint64_t &h, std::string_view str)
+    {
+        hash(h, str.data(), str.size());
+        hash(h, "", 1);
+    }
+    // size of a scalar value, or of each element of a list value, 0 for a string.
+    static constexpr size_t value_size(OptionBase::Type type)
+    {
+        switch(type)
+        {
+        case OptionBase::Bool   : return 1;
+        case OptionBase::String : return 0;
+        case OptionBase::Int32  :
+        case OptionBase::Uint32 :
+        case OptionBase::Float  : return 4;
+        default                 : return 8;
+        }
+    }
+    template<typename T>
+    static void put(char *&p, T v) { memcpy(p, &v, sizeof(T)); p += sizeof(T); }
+    template<typename T>
+    static T get(const char *&p) { T v; memcpy(&v, p, sizeof(T)); p += sizeof(T); return v; }
+public:
+    // hash of definitions of opts (such as a vector<OptionBase *>), see schema above.
+    template<typename Opts>
+    static uint64_t SchemaHash(const Opts &opts)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for(const OptionBase *opt : opts)
+        {
+            const uint8_t def[4] = { (uint8_t)opt->type, (uint8_t)opt->list, (uint8_t)opt->base, (uint8_t)opt->unit };
+            hash(h, def, sizeof(def));
+            hash(h, opt->name);
+            hash(h, opt->alt_name);
+        }
+        return h;
+    }
+    // append a blob of parsed state of opts (such as a vector<OptionBase *>) to blob.
+    template<typename Opts>
+    static void AppendTo(std::string &blob, const Opts &opts)
+    {
+        const size_t start = blob.size();
+        uint32_t num = 0;
+        blob.resize(start + header_size);
+        for(const OptionBase *opt : opts)
+        {
+            const size_t rec = blob.size();
+            blob.resize(rec + record_size);
+            opt->save_value(blob);
+            char *p = &blob[rec];
+            put<uint8_t>(p, opt->type);
+            put<uint8_t>(p, opt->status);
+            put<uint8_t>(p, opt->matched_name.empty() ? 0 :
+                            opt->matched_name.data() == opt->name.data() ? 1 : 2);
+            put<uint8_t>(p, opt->source);
+            put<uint64_t>(p, blob.size() - rec - record_size);
+            num++;
+        }
+        char *p = &blob[start];
+        memcpy(p, magic.data(), magic.size());
+        p += magic.size();
+        put<uint16_t>(p, version);
+        put<uint16_t>(p, byte_order);
+        put<uint32_t>(p, num);
+        put<uint64_t>(p, blob.size() - start);
+        put<uint64_t>(p, SchemaHash(opts));
+    }
+    // return a blob of parsed state of opts (such as a vector<OptionBase *>).
+    template<typename Opts>
+    static std::string Save(const Opts &opts)
+    {
+        std::string blob;
+        AppendTo(blob, opts);
+        return blob;
+    }
+    // load values, status and matched names of opts from a blob saved by the same options,
+    // opts are not changed unless Loaded is returned,
+    // a StaticOption<string_view> views its value in blob, which must outlive it.
+    template<typename Opts>
+    static LoadResult Load(const Opts &opts, std::string_view blob)
+    {
+        const char *p = blob.data(), *end = p + blob.size();
+        if(blob.size() < header_size || blob.substr(0, magic.size()) != magic)
+            return BlobInvalid;
+        p += magic.size();
+        const uint16_t ver = get<uint16_t>(p);
+        if(ver != version || get<uint16_t>(p) != byte_order)
+            return VersionMismatch;
+        const uint32_t num = get<uint32_t>(p);
+        const uint64_t size = get<uint64_t>(p);
+        if(size < header_size || size > blob.size())
+            return BlobInvalid;
+        end = blob.data() + size;
+        if(get<uint64_t>(p) != SchemaHash(opts))
+            return SchemaMismatch;
+        // check all records before loading any of them.
+        const char *records = p;
+        uint32_t n = 0;
+        for(const OptionBase *opt : opts)
+        {
+            if(n++ == num || end - p < (ptrdiff_t)record_size)
+                return BlobInvalid;
+            const uint8_t type = get<uint8_t>(p), status = get<uint8_t>(p), matched = get<uint8_t>(p);
+            const uint8_t source = get<uint8_t>(p);
+            const uint64_t len = get<uint64_t>(p);
+            const size_t vs = value_size(opt->type);
+            if(type != opt->type || status > OptionBase::Parsed || matched > 2 || source > OptionBase::FromFile ||
+                    (matched == 2 && opt->alt_name.empty()) || len > (uint64_t)(end - p) ||
+                    (vs && (opt->list ? len % vs != 0 : len != vs)))
+                return BlobInvalid;
+            p += len;
+        }
+        if(n != num || p != end)
+            return BlobInvalid;
+        p = records;
+        for(OptionBase *opt : opts)
+        {
+            p++;
+            opt->status = (OptionBase::Status)get<uint8_t>(p);
+            const uint8_t matched = get<uint8_t>(p);
+            opt->matched_name = matched == 0 ? std::string_view() : matched == 1 ? opt->name : opt->alt_name;
+            opt->source = (OptionBase::Source)get<uint8_t>(p);
+            const size_t len = (size_t)get<uint64_t>(p);
+            opt->load_value(std::string_view(p, len));
+            p += len;
+        }
+        return Loaded;
+    }
+    // return blob as text of hex digits, e.g. for an environment variable.
+    static std::string ToText(std::string_view blob)
+    {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string text(blob.size() * 2, '\0');
+        for(size_t i = 0; i < blob.size(); i++)
+        {
+            text[i * 2]     = digits[(uint8_t)blob[i] >> 4];
+            text[i * 2 + 1] = digits[(uint8_t)blob[i] & 15];
+        }
+        return text;
+    }
+    // decode text of ToText() into blob, return false if text is not hex digits.
+    static bool FromText(std::string_view text, std::string &blob)
+    {
+        if(text.size() % 2)
+            return false;
+        blob.resize(text.size() / 2);
+        for(size_t i = 0; i < blob.size(); i++)
+        {
+            uint8_t b;
+            if(std::from_chars(text.data() + i * 2, text.data() + i * 2 + 2, b, 16).ptr != text.data() + i * 2 + 2)
+                return false;
+            blob[i] = (char)b;
+        }
+        return true;
+    }
+};
+
+// OptionSnapshot: a generation of values and status of options registered to a LiveOptions,
+// immutable once published, so it's safe to read from any thread.
+class OptionSnapshot
+{
+    friend class LiveOptions;
+    uint64_t generation = 0;
+    std::vector<std::unique_ptr<OptionBase>> opts;
+    size_t num_unparsed_args = 0;
+    std::string first_unparsed_arg;
+public:
+    // generation of this snapshot, 0 for the initial one, increased by 1 in each publishing.
+    uint64_t Generation() const { return generation; }
+    // the copy of opt in this snapshot, opt must be registered to the LiveOptions.
+    //   e.g. snap->Get(opt_int32_f).Value()
+    template<typename O>
+    const O &Get(const O &opt) const { return static_cast<const O &>(*opts[opt.live_slot]); }
+    // all copies of options, in order of registration.
+    const std::vector<std::unique_ptr<OptionBase>> &All() const { return opts; }
+    // unparsed args while parsing this snapshot, for validating before publishing.
+    size_t NumUnparsedArgs() const { return num_unparsed_args; }
+    const std::string &FirstUnparsedArg() const { return first_unparsed_arg; }
+};
+
+// LiveOptions: hot-reloadable options for long-running services, RCU-style.
+//   * readers : Acquire() a snapshot, lock-free and never waiting for the writer, never seeing
+//               a half-updated snapshot, options registered are never written by reloading.
+//   * writer  : Reload() parses args into a new snapshot and publishes it atomically,
+//               Reload(), Publish() and Reclaim() must be called from only one thread at a time.
+// a replaced snapshot is retired, and freed by Publish() or Reclaim() once no reader holds it,
+// each reader announces the generation it acquired in a slot of it's own (epoch based reclamation),
+// so at most max_readers snapshot refs can be held at once, Acquire() waits for a free slot beyond.
+// e.g.:
+//   LiveOptions live(options);                    // after parsed options from main()'s argv.
+//   {
+//       LiveOptions::SnapshotRef snap = live.Acquire();   // in a worker thread, for a request.
+//       int32_t f = snap->Get(opt_int32_f).Value();
+//   }                                             // released, the snapshot can be freed.
+//   live.Reload(argc2, argv2);                    // in a SIGHUP handling thread.
+class LiveOptions
+{
+    std::vector<OptionBase *> opts;                           // registered options, as the schema.
+    std::unique_ptr<OptionSnapshot> current_snap;             // the current snapshot.
+    std::vector<std::unique_ptr<OptionSnapshot>> retired;     // retired snapshots not freed yet.
+    std::atomic<const OptionSnapshot *> current{nullptr};
+    std::atomic<uint64_t> generation{0};
+    // generation + 1 a reader acquired a snapshot at, 0 for a free slot,
+    // a cache line each, so that readers in different slots don't share one.
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<uint64_t> epoch{0};
+    };
+    std::unique_ptr<ReaderSlot[]> slots;
+    size_t num_slots;
+    mutable std::atomic<size_t> next_slot{0};            // where Acquire() starts looking for a free slot.
+public:
+    // a snapshot held by a reader, released by destruction, movable, not copyable.
+    class SnapshotRef
+    {
+        friend class LiveOptions;
+        const OptionSnapshot *snap = nullptr;
+        std::atomic<uint64_t> *epoch = nullptr;
+        SnapshotRef(const OptionSnapshot *snap, std::atomic<uint64_t> *epoch) : snap(snap), epoch(epoch) {}
+    public:
+        SnapshotRef() = default;
+        SnapshotRef(SnapshotRef &&o) noexcept : snap(o.snap), epoch(o.epoch) { o.snap = nullptr; o.epoch = nullptr; }
+        SnapshotRef &operator=(SnapshotRef &&o) noexcept
+        {
+            if(this != &o)
+            {
+                Release();
+                std::swap(snap, o.snap);
+                std::swap(epoch, o.epoch);
+            }
+            return *this;
+        }
+        SnapshotRef(const SnapshotRef &) = delete;
+        SnapshotRef &operator=(const SnapshotRef &) = delete;
+        ~SnapshotRef() { Release(); }
+        // release the snapshot before destruction, after that it must not be used.
+        void Release()
+        {
+            if(epoch)
+                epoch->store(0, std::memory_order_release);
+            snap = nullptr;
+            epoch = nullptr;
+        }
+        const OptionSnapshot *get() const { return snap; }
+        const OptionSnapshot *operator->() const { return snap; }
+        const OptionSnapshot &operator*() const { return *snap; }
+        explicit operator bool() const { return snap; }
+    };
+    // register opts, and publish generation 0 from their current values,
+    // an option can be registered to only one LiveOptions.
+    //   * max_readers : number of SnapshotRefs that can be held at once by all readers.
+    LiveOptions(const std::vector<OptionBase *> &opts, size_t max_readers = 64)
+        : opts(opts), slots(new ReaderSlot[std::max(max_readers, (size_t)1)]), num_slots(std::max(max_readers, (size_t)1))
+    {
+        current_snap.reset(new OptionSnapshot);
+        current_snap->opts.reserve(opts.size());
+        for(size_t i = 0; i < opts.size(); i++)
+        {
+            this->opts[i]->live_slot = i;
+            current_snap->opts.push_back(opts[i]->clone());
+        }
+        current.store(current_snap.get(), std::memory_order_seq_cst);
+    }
+    LiveOptions(const LiveOptions &) = delete;
+    LiveOptions &operator=(const LiveOptions &) = delete;
+    // all SnapshotRefs must have been released.
+    ~LiveOptions()
+    {
+        for(OptionBase *opt : opts)
+            opt->live_slot = SIZE_MAX;
+    }
+    // acquire the current snapshot by announcing it's generation in a free slot, then loading it,
+    // it's never freed until the SnapshotRef is released.
+    SnapshotRef Acquire() const
+    {
+        for(size_t i = next_slot.fetch_add(1, std::memory_order_relaxed); ; i++)
+        {
+            std::atomic<uint64_t> &epoch = slots[i % num_slots].epoch;
+            uint64_t expected = 0;
+            if(epoch.load(std::memory_order_relaxed) == 0 &&
+                    epoch.compare_exchange_strong(expected, generation.load(std::memory_order_seq_cst) + 1,
+                                                  std::memory_order_seq_cst))
+            {   // the snapshot loaded after announcing is of the generation announced or newer.
+                return SnapshotRef(current.load(std::memory_order_seq_cst), &epoch);
+            }
+            if(i % num_slots == num_slots - 1)
+                std::this_thread::yield();   // all slots are held.
+        }
+    }
+    // generation of the current snapshot, which is also the number of reloads.
+    uint64_t Generation() const { return generation.load(std::memory_order_relaxed); }
+    // parse args into a new snapshot of all registered options from their default values,
+    // without publishing it, the registered options are not changed.
+    std::unique_ptr<OptionSnapshot> Parse(int argc, const char **argv, int rsp_depth = 0) const
+    {
+        std::unique_ptr<OptionSnapshot> snap(new OptionSnapshot);
+        std::vector<OptionBase *> bases;
+        snap->opts.reserve(opts.size());
+        bases.reserve(opts.size());
+        for(const OptionBase *opt : opts)
+        {
+            snap->opts.push_back(opt->clone());
+            snap->opts.back()->reset();
+            bases.push_back(snap->opts.back().get());
+        }
+        OptionParser op(argc, argv, rsp_depth);
+        op.ParseAll(bases);
+        snap->num_unparsed_args = op.NumUnparsedArgs();
+        snap->first_unparsed_arg = op.FirstUnparsedArg();
+        return snap;
+    }
+    // publish snap as the current snapshot, retire the previous one, and Reclaim(),
+    // return the new generation.
+    uint64_t Publish(std::unique_ptr<OptionSnapshot> snap)
+    {
+        const uint64_t gen = generation.load(std::memory_order_relaxed) + 1;
+        snap->generation = gen;
+        current.store(snap.get(), std::memory_order_seq_cst);
+        generation.store(gen, std::memory_order_seq_cst);
+        retired.push_back(std::move(current_snap));
+        current_snap = std::move(snap);
+        Reclaim();
+        return gen;
+    }
+    // Parse() and Publish(), return the new generation.
+    uint64_t Reload(int argc, const char **argv, int rsp_depth = 0)
+    {
+        return Publish(Parse(argc, argv, rsp_depth));
+    }
+    // free retired snapshots older than the generations all readers acquired at,
+    // in O(max_readers + retired), no reader ever waits for it, return number of snapshots freed.
+    size_t Reclaim()
+    {
+        uint64_t oldest = UINT64_MAX;   // the oldest generation a reader may hold.
+        for(size_t i = 0; i < num_slots; i++)
+        {
+            const uint64_t e = slots[i].epoch.load(std::memory_order_seq_cst);
+            if(e)
+                oldest = std::min(oldest, e - 1);
+        }
+        const size_t num = retired.size();
+        retired.erase(std::remove_if(retired.begin(), retired.end(),
+                [oldest](const std::unique_ptr<OptionSnapshot> &snap) { return snap->generation < oldest; }),
+                retired.end());
+        return num - retired.size();
+    }
+    // number of retired snapshots not freed yet.
+    size_t NumRetired() const { return retired.size(); }
+};
+
+} // namespace loyopt
+
+#if(LOYOPTION_GLOBAL_NAMES)
+using loyopt::is_numeric_option_v;
+using loyopt::is_list_option_v;
+using loyopt::OptionHelp;
+using loyopt::PerfectHash;
+using loyopt::Choice;
+using loyopt::ChoiceSet;
+using loyopt::MakeChoiceSet;
+using loyopt::MemoryCounter;
+using loyopt::MemoryScope;
+using loyopt::StringPool;
+#if(LOYOPTION_THREADS)
+using loyopt::ParallelExecutor;
+using loyopt::WorkerPool;
+#endif
+using loyopt::OptionBase;
+using loyopt::Option;
+using loyopt::StaticString;
+using loyopt::StaticOption;
+using loyopt::NameTrie;
+using loyopt::OptionEvent;
+using loyopt::OptionObserver;
+using loyopt::OptionParser;
+using loyopt::OptionStream;
+using loyopt::Command;
+using loyopt::CommandSet;
+using loyopt::Opt;
+using loyopt::OptionSet;
+using loyopt::OptionBlob;
+using loyopt::OptionSnapshot;
+using loyopt::LiveOptions;
+#endif
+
 #endif
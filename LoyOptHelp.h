@@ -0,0 +1,72 @@
+/*
+ * LoyOptHelp.h
+ *
+ *  Created on: Nov 28, 2022
+ *      Author: loywong@gmail.com, github.com/loykylewong
+ *     License: MIT License, Copyright (c) 2023 Loy Kyle Wong
+ */
+
+#ifndef __LOYOPTHELP_H__
+#define __LOYOPTHELP_H__
+
+#include "LoyOpt.h"
+
+#include <iostream>
+
+// ==== LoyOptHelp ===
+//
+// Optional iostream helpers of LoyOpt.h, include it only in translation units printing
+// help or debug info, so that others including LoyOpt.h never parse iostream headers.
+//   * os << opt          : help text of an option, same as opt.HelpText().
+//   * PrintHelp(os, ...) : help text of all options.
+//   * StreamObserver     : an OptionObserver printing all parsing events to an ostream, e.g.
+//                          op.SetObserver(&StreamObserver, &cerr), or for all parsers
+//                          OptionParser::SetDefaultObserver(&StreamObserver, &cerr).
+
+namespace loyopt
+{
+
+inline std::ostream &operator<<(std::ostream &os, const OptionBase &opt)
+{
+    const std::string &text = opt.HelpText();
+    return os.write(text.data(), (std::streamsize)text.size());
+}
+
+// print help text of all opts (such as a vector<OptionBase *>) to os, rendered in one buffer.
+template<typename Opts>
+void PrintHelp(std::ostream &os, const Opts &opts)
+{
+    std::string buf;
+    OptionBase::AppendAllHelpTo(buf, opts);
+    os.write(buf.data(), (std::streamsize)buf.size());
+}
+
+#if(LOYOPTION_OBSERVER)
+// print each parsing event as a line to the ostream ctx, or cout if ctx is nullptr.
+inline void StreamObserver(const OptionEvent &ev, void *ctx)
+{
+    static const char *const kinds[] =
+    {
+        "ArgTokenized ", "OptionMatched", "ValueClamped ",
+        "ValueInvalid ", "UnparsedArg  ", "OptionParsed "
+    };
+    std::ostream &os = ctx ? *(std::ostream *)ctx : std::cout;
+    os << "[" << kinds[ev.kind] << "] " << ev.where;
+    if(ev.index != SIZE_MAX)
+        os << " : args[" << ev.index << "] @" << ev.offset << " \"" << ev.arg << "\"";
+    if(ev.opt)
+        os << " : [" << ev.opt->GetStatusString() << "] " << ev.opt->GetName();
+    os << '\n';
+}
+#endif
+
+} // namespace loyopt
+
+#if(LOYOPTION_GLOBAL_NAMES)
+using loyopt::PrintHelp;
+#if(LOYOPTION_OBSERVER)
+using loyopt::StreamObserver;
+#endif
+#endif
+
+#endif
@@ -0,0 +1,576 @@
+#define LOYOPTION_VERBOSE false
+#include "LoyOpt.h"
+#include "fuzzLoyOpt.h"
+
+#include <chrono>
+#include <sstream>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <new>
+#include <cstdlib>
+
+using namespace std;
+
+// ==== bench_loyopt ===
+//
+// A self-contained benchmark of LoyOpt hot paths, reports time and heap allocations per op.
+//
+// Usage: bench_loyopt [-t <ms>] [--max_n <n>] [--check]
+//   * -t      : minimal measuring time of each case in milliseconds, default 200.
+//   * --max_n : max option count / arg count of the scaling cases, default 10000.
+//   * --check : exit with 1 if time or heap bytes per byte of adversarial inputs (see
+//               fuzzLoyOpt.h) grow more than 4x from the smallest to the largest input,
+//               such as a quadratic path, for tracking regressions.
+
+// ---- allocation counting, by replacing global operator new / delete ----
+// all of the replaceable forms are defined, so that each new is paired with it's own delete.
+// gcc warns -Wmismatched-new-delete at free() in them once they are inlined into a caller whose
+// pointer came from operator new, a false positive since operator new here is malloc(),
+// so the warning is silenced for these definitions only.
+static size_t num_allocs = 0;
+static size_t num_alloc_bytes = 0;
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static void *counted_alloc(size_t size)
+{
+    num_allocs++;
+    num_alloc_bytes += size;
+    if(void *p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+// aligned ones, used by pmr::new_delete_resource().
+static void *counted_alloc(size_t size, align_val_t align)
+{
+    num_allocs++;
+    num_alloc_bytes += size;
+    const size_t a = max((size_t)align, sizeof(void *));
+    if(void *p = aligned_alloc(a, (size + a - 1) / a * a))
+        return p;
+    throw bad_alloc();
+}
+void *operator new  (size_t size) { return counted_alloc(size); }
+void *operator new[](size_t size) { return counted_alloc(size); }
+void *operator new  (size_t size, align_val_t align) { return counted_alloc(size, align); }
+void *operator new[](size_t size, align_val_t align) { return counted_alloc(size, align); }
+void operator delete  (void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete  (void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+void operator delete  (void *p, align_val_t) noexcept { free(p); }
+void operator delete[](void *p, align_val_t) noexcept { free(p); }
+void operator delete  (void *p, size_t, align_val_t) noexcept { free(p); }
+void operator delete[](void *p, size_t, align_val_t) noexcept { free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// ---- measuring ----
+using Clock = chrono::steady_clock;
+
+static double min_time_ms = 200.0;
+
+// an argv with storage of its strings.
+struct Argv
+{
+    vector<string> strs;
+    vector<const char *> ptrs;
+    void Add(const string &s) { strs.push_back(s); }
+    const char **Get()
+    {
+        ptrs.clear();
+        for(const string &s : strs)
+            ptrs.push_back(s.c_str());
+        return ptrs.data();
+    }
+    int Count() const { return (int)strs.size(); }
+};
+
+// run op until min_time_ms elapsed, setup is not measured.
+//   * name  : name of the case.
+//   * items : number of items (args / options / values) processed in each op.
+//   * return : ns and heap bytes per item.
+struct CaseResult
+{
+    double ns_per_item;
+    double bytes_per_item;
+};
+static CaseResult run_case(const string &name, size_t items,
+        const function<void()> &setup, const function<void()> &op)
+{
+    size_t iters = 0, allocs = 0, bytes = 0;
+    Clock::duration elapsed{};
+    while(chrono::duration<double, milli>(elapsed).count() < min_time_ms || iters < 3)
+    {
+        setup();
+        size_t a0 = num_allocs, b0 = num_alloc_bytes;
+        Clock::time_point t0 = Clock::now();
+        op();
+        elapsed += Clock::now() - t0;
+        allocs += num_allocs - a0;
+        bytes += num_alloc_bytes - b0;
+        iters++;
+    }
+    double ns = chrono::duration<double, nano>(elapsed).count() / iters;
+    printf("%-36s %8zu %12.1f %10.2f %10.1f %10.1f %12.1f\n", name.c_str(), iters, ns,
+            ns / (items ? items : 1), (double)allocs / iters, (double)allocs / iters / (items ? items : 1),
+            (double)bytes / iters);
+    return {ns / (items ? items : 1), (double)bytes / iters / (items ? items : 1)};
+}
+
+static void print_header(const char *title)
+{
+    printf("\n---- %s ----\n", title);
+    printf("%-36s %8s %12s %10s %10s %10s %12s\n",
+            "case", "iters", "ns/op", "ns/item", "allocs/op", "allocs/item", "bytes/op");
+}
+
+// ---- cases ----
+
+// n int32 options "--opt<k>", and an argv of "--opt<k> <k>" for each.
+struct IntOptions
+{
+    vector<unique_ptr<Option<int32_t>>> opts;
+    vector<OptionBase *> bases;
+    Argv argv;
+    IntOptions(size_t n)
+    {
+        argv.Add("./bench_loyopt");
+        for(size_t k = 0; k < n; k++)
+        {
+            opts.emplace_back(new Option<int32_t>(0, "--opt" + to_string(k)));
+            bases.push_back(opts.back().get());
+            argv.Add("--opt" + to_string(k));
+            argv.Add(to_string(k));
+        }
+    }
+};
+
+static void bench_scaling(size_t max_n)
+{
+    print_header("OptionParser construction, n = number of options, 2n args");
+    for(size_t n = 10; n <= max_n; n *= 10)
+    {
+        IntOptions io(n);
+        const char **argv = io.argv.Get();
+        run_case("ctor n=" + to_string(n), io.argv.Count(), []{}, [&]{ OptionParser op(io.argv.Count(), argv); });
+    }
+
+    print_header("Parse() per option vs ParseAll(), not including construction");
+    for(size_t n = 10; n <= max_n; n *= 10)
+    {
+        IntOptions io(n);
+        const char **argv = io.argv.Get();
+        unique_ptr<OptionParser> op;
+        auto setup = [&]{ op.reset(); op.reset(new OptionParser(io.argv.Count(), argv)); };
+        run_case("Parse() x n, n=" + to_string(n), n, setup, [&]{
+            for(OptionBase *o : io.bases)
+                op->Parse(*o);
+        });
+        run_case("ParseAll(), n=" + to_string(n), n, setup, [&]{ op->ParseAll(io.bases); });
+    }
+}
+
+static void bench_reparse()
+{
+    print_header("Reparse() + ParseAll() steady state, 1000 argv sets of 20 options");
+    const size_t n = 20, num_sets = 1000;
+    IntOptions io(n);
+    Option<string> opt_str("", "--str");
+    Option<vector<int32_t>> opt_list({}, "--list");
+    io.bases.push_back(&opt_str);
+    io.bases.push_back(&opt_list);
+    vector<Argv> sets(num_sets);
+    vector<const char **> argvs;
+    for(size_t k = 0; k < num_sets; k++)
+    {
+        sets[k].Add("./bench_loyopt");
+        for(size_t j = 0; j < n; j += 2)
+        {
+            sets[k].Add("--opt" + to_string(j));
+            sets[k].Add(to_string(k + j));
+        }
+        sets[k].Add("--str");
+        sets[k].Add("/path/to/job_" + to_string(k));
+        sets[k].Add("--list");
+        sets[k].Add(to_string(k) + ",1,2,3");
+        sets[k].Add("-abc");
+        argvs.push_back(sets[k].Get());
+    }
+    OptionParser op(sets[0].Count(), argvs[0]);
+    auto reparse_all = [&]{
+        for(size_t k = 0; k < num_sets; k++)
+        {
+            for(OptionBase *o : io.bases)
+                o->Reset();
+            op.Reparse(sets[k].Count(), argvs[k]);
+            op.ParseAll(io.bases);
+        }
+    };
+    reparse_all();  // warm up
+    run_case("Reset() + Reparse() + ParseAll()", num_sets, []{}, reparse_all);
+    run_case("ctor + ParseAll()", num_sets, []{}, [&]{
+        for(size_t k = 0; k < num_sets; k++)
+        {
+            OptionParser op(sets[k].Count(), argvs[k]);
+            op.ParseAll(io.bases);
+        }
+    });
+    static char arena_buf[1 << 16];
+    pmr::monotonic_buffer_resource arena(arena_buf, sizeof(arena_buf));
+    size_t arena_bytes = 0;
+    run_case("ctor + ParseAll() in an arena", num_sets, []{}, [&]{
+        for(size_t k = 0; k < num_sets; k++)
+        {
+            {
+                OptionParser op(sets[k].Count(), argvs[k], 0, &arena);
+                op.ParseAll(io.bases);
+                arena_bytes = op.BytesUsed();
+            }
+            arena.release();
+        }
+    });
+    printf("%-36s %zu\n", "  OptionParser::BytesUsed()", arena_bytes);
+}
+
+static void bench_blob(size_t max_n)
+{
+    print_header("OptionBlob vs parsing args, n = number of options");
+    for(size_t n = 10; n <= max_n; n *= 10)
+    {
+        IntOptions io(n);
+        const char **argv = io.argv.Get();
+        run_case("ctor + ParseAll(), n=" + to_string(n), n, []{}, [&]{
+            OptionParser op(io.argv.Count(), argv);
+            op.ParseAll(io.bases);
+        });
+        string blob;
+        run_case("Save(), n=" + to_string(n), n, []{}, [&]{ blob = OptionBlob::Save(io.bases); });
+        run_case("Load(), n=" + to_string(n), n, []{}, [&]{ OptionBlob::Load(io.bases, blob); });
+    }
+}
+
+static void bench_merged_flags()
+{
+    print_header("merged short flags, 26 bool options, n = merged args of \"-abc..z\"");
+    vector<unique_ptr<Option<bool>>> opts;
+    vector<OptionBase *> bases;
+    for(char c = 'a'; c <= 'z'; c++)
+    {
+        opts.emplace_back(new Option<bool>(string{'-', c}));
+        bases.push_back(opts.back().get());
+    }
+    for(size_t n = 1; n <= 1000; n *= 10)
+    {
+        Argv av;
+        av.Add("./bench_loyopt");
+        for(size_t k = 0; k < n; k++)
+            av.Add("-abcdefghijklmnopqrstuvwxyz");
+        const char **argv = av.Get();
+        run_case("ctor, n=" + to_string(n), n * 26, []{}, [&]{ OptionParser op(av.Count(), argv); });
+        run_case("ctor + ParseAll(), n=" + to_string(n), n * 26, []{}, [&]{
+            OptionParser op(av.Count(), argv);
+            op.ParseAll(bases);
+        });
+    }
+}
+
+// 1000 options of type T, each with a value literal.
+template<typename T>
+static void bench_numeric_type(const char *type_name, const function<string(size_t)> &literal,
+        OptionBase::Unit unit = OptionBase::NoUnit)
+{
+    const size_t n = 1000;
+    vector<unique_ptr<Option<T>>> opts;
+    vector<OptionBase *> bases;
+    Argv av;
+    av.Add("./bench_loyopt");
+    for(size_t k = 0; k < n; k++)
+    {
+        opts.emplace_back(new Option<T>(T{}, "--v" + to_string(k)));
+        opts.back()->SetUnit(unit);
+        bases.push_back(opts.back().get());
+        av.Add("--v" + to_string(k));
+        av.Add(literal(k));
+    }
+    const char **argv = av.Get();
+    unique_ptr<OptionParser> op;
+    run_case(string("ParseAll() of ") + type_name + " x1000", n,
+            [&]{ op.reset(); op.reset(new OptionParser(av.Count(), argv)); },
+            [&]{ op->ParseAll(bases); });
+}
+
+static void bench_numeric()
+{
+    print_header("numeric value parsing per type");
+    bench_numeric_type<int32_t >("int32_t ", [](size_t k){ return to_string((int32_t)(k * 2654435761u) >> 1); });
+    bench_numeric_type<uint32_t>("uint32_t", [](size_t k){ return to_string((uint32_t)(k * 2654435761u)); });
+    bench_numeric_type<int64_t >("int64_t ", [](size_t k){ return to_string((int64_t)(k * 0x9e3779b97f4a7c15ull) >> 1); });
+    bench_numeric_type<float   >("float   ", [](size_t k){ return to_string(k * 1.2345f); });
+    bench_numeric_type<double  >("double  ", [](size_t k){ return to_string(k * 1.23456789e-3); });
+    bench_numeric_type<string  >("string  ", [](size_t k){ return "/path/to/file_" + to_string(k); });
+    bench_numeric_type<int64_t >("int64_t bytes", [](size_t k){ return to_string(k) + (k & 1 ? "MiB" : "K"); },
+            OptionBase::Bytes);
+    bench_numeric_type<int64_t >("int64_t ms   ", [](size_t k){ return to_string(k) + (k & 1 ? "s" : "ms"); },
+            OptionBase::Milliseconds);
+}
+
+// one list option of T, with n elements in a single arg, parsed by up to threads threads if not 0.
+template<typename T>
+static void bench_list_type(const char *type_name, size_t n, const function<string(size_t)> &literal,
+        unsigned threads = 0)
+{
+    Option<vector<T>> opt({}, "--list");
+    if(threads)
+        opt.SetParallel(1 << 22, 1 << 18, threads);
+    vector<OptionBase *> bases{ &opt };
+    string list;
+    for(size_t k = 0; k < n; k++)
+        list += (k ? "," : "") + literal(k);
+    Argv av;
+    av.Add("./bench_loyopt");
+    av.Add("--list");
+    av.Add(list);
+    const char **argv = av.Get();
+    unique_ptr<OptionParser> op;
+    run_case(string("ParseAll() list of ") + type_name + " x" + to_string(n), n,
+            [&]{ op.reset(); op.reset(new OptionParser(av.Count(), argv)); },
+            [&]{ op->ParseAll(bases); });
+}
+
+static void bench_list()
+{
+    print_header("list option parsing, n = number of elements");
+    bench_list_type<int32_t >("int32_t ", 100000, [](size_t k){ return to_string((int32_t)(k * 2654435761u) >> 8); });
+    bench_list_type<uint32_t>("uint32_t", 100000, [](size_t k){ return to_string((uint32_t)(k * 2654435761u)); });
+    bench_list_type<double  >("double  ", 100000, [](size_t k){ return to_string(k * 1.23456789e-3); });
+    const unsigned threads = max(thread::hardware_concurrency(), 1u);
+    const string par = "par" + to_string(threads);
+    bench_list_type<int64_t >(("int64_t " + par).c_str(), 2000000,
+            [](size_t k){ return to_string(k * 2654435761u); }, threads);
+    bench_list_type<int64_t >("int64_t ", 2000000, [](size_t k){ return to_string(k * 2654435761u); });
+    bench_list_type<double  >(("double  " + par).c_str(), 2000000,
+            [](size_t k){ return to_string(k * 1.23456789e-3); }, threads);
+    bench_list_type<double  >("double  ", 2000000, [](size_t k){ return to_string(k * 1.23456789e-3); });
+}
+
+static void bench_help(size_t max_n)
+{
+    print_header("help rendering, n = number of options, 2 help lines each");
+    for(size_t n = 10; n <= max_n; n *= 10)
+    {
+        IntOptions io(n);
+        for(auto &o : io.opts)
+            o->HelpLines = {"First line of help info of this option.", "    second line of help info of this option."};
+        size_t k = 0;
+        // alternate the 2nd line between 2 interned ones, so that each render misses the cache.
+        run_case("1st render, x n, n=" + to_string(n), n,
+                [&]{
+                    const char *line = k++ & 1 ? "    second line, odd." : "    second line, even.";
+                    for(auto &o : io.opts)
+                        o->HelpLines = {"First line of help info of this option.", line};
+                },
+                [&]{
+                    string buf;
+                    OptionBase::AppendAllHelpTo(buf, io.bases);
+                });
+        run_case("AppendAllHelpTo() cached, n=" + to_string(n), n, []{}, [&]{
+            string buf;
+            OptionBase::AppendAllHelpTo(buf, io.bases);
+        });
+        run_case("AppendHelpLinesTo() x n, n=" + to_string(n), n, []{}, [&]{
+            stringstream ss;
+            for(const OptionBase *o : io.bases)
+                o->AppendHelpLinesTo(ss);
+        });
+    }
+}
+
+static void bench_format(size_t max_n)
+{
+    print_header("value formatting, n = number of options, value, min and max of each");
+    for(size_t n = 10; n <= max_n; n *= 10)
+    {
+        IntOptions io(n);
+        run_case("Get*ValueString() x n, n=" + to_string(n), n, []{}, [&]{
+            string buf;
+            for(const OptionBase *o : io.bases)
+                buf.append(o->GetValueString()).append(o->GetMinValueString()).append(o->GetMaxValueString());
+        });
+        string buf;
+        run_case("AppendValueTo() x n, n=" + to_string(n), n, []{}, [&]{
+            buf.clear();
+            for(const OptionBase *o : io.bases)
+            {
+                o->AppendValueTo(buf);
+                o->AppendValueTo(buf, OptionBase::FieldMin);
+                o->AppendValueTo(buf, OptionBase::FieldMax);
+            }
+        });
+        run_case("AppendAllValuesTo(), n=" + to_string(n), n, []{}, [&]{
+            string buf;
+            OptionBase::AppendAllValuesTo(buf, io.bases);
+        });
+    }
+}
+
+static void bench_stream(size_t max_n)
+{
+    print_header("OptionStream in 4KiB chunks vs OptionParser, n = number of options");
+    for(size_t n = 10; n <= max_n; n *= 10)
+    {
+        IntOptions io(n);
+        const char **argv = io.argv.Get();
+        string text;
+        for(int i = 1; i < io.argv.Count(); i++)
+            text.append(argv[i]).push_back(' ');
+        run_case("ctor + ParseAll(), n=" + to_string(n), n, []{}, [&]{
+            OptionParser op(io.argv.Count(), argv);
+            op.ParseAll(io.bases);
+        });
+        OptionStream os(io.bases);
+        run_case("Feed() + Finish(), n=" + to_string(n), n, []{}, [&]{
+            os.Begin();
+            for(size_t i = 0; i < text.size(); i += 4096)
+                os.Feed(text.data() + i, min<size_t>(4096, text.size() - i));
+            os.Finish();
+        });
+    }
+}
+
+// names and help lines of an option as stored before StringPool, per option.
+struct LegacyMeta
+{
+    pmr::string name_str, alt_name_str;
+    pmr::vector<pmr::string> HelpLines;
+};
+
+static void bench_footprint(size_t max_n)
+{
+    static const char *const names[][2] =
+    {
+        {"--plugin.threads", "-t"}, {"--plugin.queue-depth", "-q"}, {"--plugin.timeout-ms", ""},
+        {"--plugin.retries", "-r"}, {"--plugin.batch-bytes", ""}, {"--plugin.log-level", "-l"},
+        {"--plugin.cache-entries", ""}, {"--plugin.flush-interval-ms", ""}
+    };
+    static const char *const help[] =
+    {
+        "number of the option's unit used by each instance of the plugin,",
+        "    0 for the default chosen by the plugin host at start up."
+    };
+    printf("\n---- %s ----\n", "footprint of options, n = number of options, of n / 8 plugin instances");
+    printf("%-36s %8zu\n", "sizeof(Option<int32_t>)", sizeof(Option<int32_t>));
+    printf("%-36s %8zu\n", "sizeof(...), before StringPool",
+            sizeof(Option<int32_t>) - sizeof(OptionHelp) + sizeof(LegacyMeta));
+    printf("%-36s %8s %12s %12s %12s\n", "case", "n", "heap bytes", "bytes/item", "pool bytes");
+    for(size_t n = 80; n <= max_n * 8; n *= 10)
+    {
+        const size_t b0 = num_alloc_bytes;
+        size_t pool_bytes;
+        {
+            // a pool of the plugin instances, included in heap bytes, freed with them.
+            StringPool pool;
+            MemoryScope scope(nullptr, &pool);
+            vector<unique_ptr<Option<int32_t>>> opts;
+            opts.reserve(n);
+            for(size_t k = 0; k < n; k++)
+            {
+                opts.emplace_back(new Option<int32_t>(0, names[k % 8][0], names[k % 8][1]));
+                for(const char *line : help)
+                    opts.back()->HelpLines.push_back(line);
+            }
+            pool_bytes = pool.BytesReserved();
+        }
+        const size_t bytes = num_alloc_bytes - b0 - n * sizeof(void *);
+        printf("%-36s %8zu %12zu %12.1f %12zu\n", "Option<int32_t> + names + help", n, bytes,
+                (double)bytes / n, pool_bytes);
+        const size_t l0 = num_alloc_bytes;
+        {
+            vector<LegacyMeta> metas(n);
+            for(size_t k = 0; k < n; k++)
+            {
+                metas[k].name_str = names[k % 8][0];
+                metas[k].alt_name_str = names[k % 8][1];
+                for(const char *line : help)
+                    metas[k].HelpLines.emplace_back(line);
+            }
+        }
+        const size_t legacy = num_alloc_bytes - l0 + n * (sizeof(Option<int32_t>) - sizeof(OptionHelp));
+        printf("%-36s %8zu %12zu %12.1f %12s\n", "  before StringPool", n, legacy, (double)legacy / n, "-");
+    }
+}
+
+// ctor + ParseAll() of adversarial inputs of GenerateArgv() from 1KiB to 1MiB,
+// time and heap bytes per byte of input should stay flat.
+//   * return : false if any of them grows more than 4x from the smallest input to the largest.
+static bool bench_adversarial()
+{
+    static const pair<GenKind, const char *> kinds[] =
+    {
+        {GenKind::HugeArgv, "huge argv"}, {GenKind::MergedFlags, "merged flags"},
+        {GenKind::LongNumbers, "long numbers"}, {GenKind::Mixed, "mixed"}
+    };
+    print_header("adversarial inputs of fuzzLoyOpt.h, n = bytes of args, items are bytes");
+    FuzzOptions fo;
+    bool ok = true;
+    for(const auto &kind : kinds)
+    {
+        CaseResult first{}, last{};
+        for(size_t n = 1 << 10; n <= 1 << 20; n <<= 2)
+        {
+            const string input = GenerateArgv(kind.first, n, n);
+            string storage;
+            const vector<const char *> argv = ArgvOf("./bench_loyopt", input.data(), input.size(), storage);
+            last = run_case(string(kind.second) + ", n=" + to_string(n), input.size(),
+                    [&]{ for(OptionBase *o : fo.all) o->Reset(); },
+                    [&]{
+                        OptionParser op((int)argv.size(), (const char **)argv.data());
+                        op.ParseAll(fo.all);
+                    });
+            if(n == 1 << 10)
+                first = last;
+        }
+        const double time_growth = last.ns_per_item / first.ns_per_item;
+        const double bytes_growth = first.bytes_per_item > 0 ? last.bytes_per_item / first.bytes_per_item : 1.0;
+        const bool flat = time_growth <= 4.0 && bytes_growth <= 4.0;
+        printf("%-36s %8s %12.2fx %9.2fx %s\n", (string(kind.second) + ", growth").c_str(), "",
+                time_growth, bytes_growth, flat ? "" : "REGRESSION");
+        ok = ok && flat;
+    }
+    return ok;
+}
+
+int main(int argc, const char *argv[])
+{
+    Option<double>   opt_time (200.0, 1.0, 100000.0, "-t");
+    Option<uint32_t> opt_max_n(10000, 10, 1000000, "--max_n");
+    Option<bool>     opt_check("--check");
+    vector<OptionBase *> options{ &opt_time, &opt_max_n, &opt_check };
+    OptionParser op(argc, argv);
+    op.ParseAll(options);
+    if(!op.FirstUnparsedArg().empty())
+    {
+        printf("Unrecognised option \"%s\".\n", string(op.FirstUnparsedArg()).c_str());
+        return 1;
+    }
+    min_time_ms = opt_time.Value();
+
+    printf("LoyOpt benchmark, min time of each case = %.0f ms.\n", min_time_ms);
+    bench_scaling(opt_max_n.Value());
+    bench_reparse();
+    bench_blob(opt_max_n.Value());
+    bench_merged_flags();
+    bench_numeric();
+    bench_list();
+    bench_help(opt_max_n.Value());
+    bench_format(opt_max_n.Value());
+    bench_stream(opt_max_n.Value());
+    bench_footprint(opt_max_n.Value());
+    const bool flat = bench_adversarial();
+    return opt_check.Value() && !flat ? 1 : 0;
+}
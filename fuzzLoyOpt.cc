@@ -0,0 +1,219 @@
+#define LOYOPTION_VERBOSE false
+#define LOYOPTION_OBSERVER true     // for the order of options matched by ParseAll().
+#include "fuzzLoyOpt.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+// ==== fuzz_loyopt ===
+//
+// A fuzz target of the tokenizer and parsing paths, an input is args terminated by '\0',
+// checked by the invariants below, a failure aborts.
+//   * OptionParser's constructor (merged short flags, "--name=value") and ParseAll() with prefix matching.
+//   * Parse() of each option, after Reset(), and Parse() agreeing with ParseAll(), called for
+//     options but lists in order of their 1st occurrences matched by ParseAll(), then for the others.
+//   * FormatValue() within FormatSize(), and OptionBlob Save() / Load() round trip.
+//   * OptionStream fed the input in chunks of sizes taken from the input.
+//   * OptionParser::Complete() of "--complete" inputs.
+//
+// Built with it's own driver by default, or as a libFuzzer target with clang by
+// cmake -DLOYOPT_LIBFUZZER=ON, e.g. "fuzz_loyopt -max_len=65536 corpus/".
+//
+// Usage of the driver: fuzz_loyopt [--iters <n>] [--seed <s>] [--max_len <n>] [files...]
+//   * files     : inputs to run, such as crashes found by libFuzzer, instead of generated ones.
+//   * --iters   : number of inputs generated by GenerateArgv(), default 2000.
+//   * --seed    : seed of the 1st input, default 1.
+//   * --max_len : max bytes of an input generated, default 65536.
+
+#define FUZZ_CHECK(cond) \
+    do { if(!(cond)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); abort(); } } while(0)
+
+static void check_format(const OptionBase &opt)
+{
+    static const OptionBase::Field fields[] =
+    {
+        OptionBase::FieldValue, OptionBase::FieldDefault, OptionBase::FieldMin, OptionBase::FieldMax
+    };
+    string buf;
+    for(OptionBase::Field field : fields)
+    {
+        buf.assign(opt.FormatSize(field), '\0');
+        const char *e = opt.FormatValue(buf.data(), buf.data() + buf.size(), field);
+        FUZZ_CHECK(e && e <= buf.data() + buf.size());
+    }
+}
+
+static void check_same(const OptionBase &a, const OptionBase &b)
+{
+    string va, vb;
+    a.AppendValueTo(va);
+    b.AppendValueTo(vb);
+    FUZZ_CHECK(va == vb);
+    FUZZ_CHECK(a.GetStatus() == b.GetStatus());
+    FUZZ_CHECK(a.GetLastMatchedName() == b.GetLastMatchedName());
+}
+
+// opts matched by ParseAll(), in order of their 1st occurrences, by the observer.
+static void record_matched(const OptionEvent &ev, void *ctx)
+{
+    auto &order = *(vector<const OptionBase *> *)ctx;
+    if(ev.kind == OptionEvent::OptionMatched && find(order.begin(), order.end(), ev.opt) == order.end())
+        order.push_back(ev.opt);
+}
+
+static FILE *null_output()
+{
+    static FILE *f = fopen("/dev/null", "w");
+    return f;
+}
+
+static int fuzz_one(const uint8_t *data, size_t size)
+{
+    static FuzzOptions fo, loaded, parsed;
+    string storage;
+    vector<const char *> argv = ArgvOf("fuzz_loyopt", (const char *)data, size, storage);
+    const int argc = (int)argv.size();
+    if(argc > 1 && strcmp(argv[1], "--complete") == 0 && null_output())
+    {
+        FUZZ_CHECK(OptionParser::Complete(argc, argv.data(), fo.all, null_output()));
+        return 0;
+    }
+    {
+        for(OptionBase *opt : fo.all)
+            opt->Reset();
+        OptionParser op(argc, argv.data());
+        op.SetPrefixMatch(true);
+        const size_t num_matched = op.ParseAll(fo.all);
+        FUZZ_CHECK(num_matched <= fo.all.size());
+        size_t num_unparsed = 0;
+        for(auto it = op.UnparsedArgs().begin(); it != op.UnparsedArgs().end(); ++it)
+            num_unparsed++;
+        FUZZ_CHECK(num_unparsed == op.NumUnparsedArgs());
+        FUZZ_CHECK(op.FirstUnparsedArg() == (num_unparsed ? *op.UnparsedArgs().begin() : string_view()));
+        for(const OptionBase *opt : fo.all)
+            check_format(*opt);
+        const string blob = OptionBlob::Save(fo.all);
+        FUZZ_CHECK(OptionBlob::Load(loaded.all, blob) == OptionBlob::Loaded);
+        for(size_t k = 0; k < fo.all.size(); k++)
+            check_same(*fo.all[k], *loaded.all[k]);
+    }
+    {
+        for(OptionBase *opt : fo.all)
+            opt->Reset();
+        OptionParser op(argc, argv.data());
+        for(OptionBase *opt : fo.all)
+            op.Parse(*opt);
+        FUZZ_CHECK(op.NumUnparsedArgs() <= op.NumArgs());
+        for(const OptionBase *opt : fo.all)
+            check_format(*opt);
+    }
+    {   // matching names exactly by default, ParseAll() is same as Parse() in order of matched ones,
+        // of options but lists, whose later occurrences Parse() takes before options parsed after.
+        vector<OptionBase *> all, each;
+        for(size_t k = 0; k < fo.all.size(); k++)
+        {
+            if(fo.all[k]->IsList())
+                continue;
+            all.push_back(fo.all[k]);
+            each.push_back(parsed.all[k]);
+            all.back()->Reset();
+            each.back()->Reset();
+        }
+        vector<const OptionBase *> order;
+        OptionParser op_all(argc, argv.data());
+        op_all.SetObserver(&record_matched, &order);
+        op_all.ParseAll(all);
+        OptionParser op(argc, argv.data());
+        for(const OptionBase *opt : order)
+            op.Parse(*each[find(all.begin(), all.end(), opt) - all.begin()]);
+        for(size_t k = 0; k < all.size(); k++)
+        {
+            if(find(order.begin(), order.end(), all[k]) == order.end())
+                op.Parse(*each[k]);
+            check_same(*all[k], *each[k]);
+        }
+        FUZZ_CHECK(op.NumUnparsedArgs() == op_all.NumUnparsedArgs());
+    }
+    {
+        for(OptionBase *opt : fo.all)
+            opt->Reset();
+        OptionStream os(fo.all);
+        const char *p = (const char *)data, *end = p + size;
+        while(p < end)
+        {
+            const size_t n = min<size_t>(end - p, 1 + (uint8_t)p[0] % 64);
+            os.Feed(p, n);
+            p += n;
+        }
+        FUZZ_CHECK(os.Finish() <= fo.all.size());
+        FUZZ_CHECK(os.TokenCapacity() <= 2 * size + 32);   // bounded by the largest token.
+        for(const OptionBase *opt : fo.all)
+            check_format(*opt);
+    }
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    return fuzz_one(data, size);
+}
+
+#ifndef LOYOPT_LIBFUZZER
+int main(int argc, const char *argv[])
+{
+    Option<uint32_t> opt_iters  (2000 , "--iters");
+    Option<uint32_t> opt_seed   (1    , "--seed");
+    Option<uint32_t> opt_max_len(65536, 1, 1 << 26, "--max_len");
+    vector<OptionBase *> options{ &opt_iters, &opt_seed, &opt_max_len };
+    OptionParser op(argc, argv);
+    op.ParseAll(options);
+    size_t num = 0, bytes = 0, worst_size = 0;
+    double worst_ns_per_byte = 0;
+    auto run = [&](const string &input)
+    {
+        const auto t0 = chrono::steady_clock::now();
+        fuzz_one((const uint8_t *)input.data(), input.size());
+        const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+        const double ns_per_byte = ns / (input.size() ? input.size() : 1);
+        if(input.size() >= 256 && ns_per_byte > worst_ns_per_byte)
+        {
+            worst_ns_per_byte = ns_per_byte;
+            worst_size = input.size();
+        }
+        num++;
+        bytes += input.size();
+    };
+    for(string_view path : op.UnparsedArgs())
+    {
+        const string p(path);
+        FILE *f = fopen(p.c_str(), "rb");
+        if(!f)
+        {
+            printf("Cannot open \"%s\".\n", p.c_str());
+            return 1;
+        }
+        string input;
+        char buf[4096];
+        for(size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0; )
+            input.append(buf, n);
+        fclose(f);
+        run(input);
+    }
+    if(op.NumUnparsedArgs() == 0)
+    {
+        FuzzRandom rnd(opt_seed.Value());
+        for(uint32_t i = 0; i < opt_iters.Value(); i++)
+        {
+            // sizes spread over magnitudes, so that both short and huge inputs are covered.
+            const size_t max_len = (size_t)1 << rnd.Below(27);
+            const size_t len = 1 + rnd.Below(min<size_t>(max_len, opt_max_len.Value()));
+            run(GenerateArgv((GenKind)(i % 4), len, opt_seed.Value() + i));
+        }
+    }
+    printf("%zu inputs, %zu bytes, worst %.1f ns/byte of %zu bytes\n", num, bytes, worst_ns_per_byte, worst_size);
+    return 0;
+}
+#endif
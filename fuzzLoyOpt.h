@@ -0,0 +1,205 @@
+/*
+ * fuzzLoyOpt.h
+ *
+ *  Created on: Nov 28, 2022
+ *      Author: loywong@gmail.com, github.com/loykylewong
+ *     License: MIT License, Copyright (c) 2023 Loy Kyle Wong
+ */
+
+#ifndef __FUZZLOYOPT_H__
+#define __FUZZLOYOPT_H__
+
+#include "LoyOpt.h"
+
+#include <string>
+#include <vector>
+
+// ==== fuzzLoyOpt.h ===
+//
+// Options of all types, and a synthetic generator of adversarial argv for them,
+// shared by fuzz_loyopt (inputs) and bench_loyopt (scaling cases).
+//   * FuzzOptions  : one option of each type, unit and base, with names of single chars
+//                    that merged short flags can mix, and long names sharing prefixes.
+//   * GenerateArgv : args of a kind of adversarial input of about n bytes, each args
+//                    terminated by '\0', same as an input of fuzz_loyopt.
+//   * ArgvOf       : pointers to args split at '\0', for an OptionParser.
+
+enum class FuzzMode { Fast, Safe, Fancy };
+static constexpr loyopt::Choice<FuzzMode> fuzz_mode_choices[] =
+{
+    {"fast", FuzzMode::Fast}, {"safe", FuzzMode::Safe}, {"fancy", FuzzMode::Fancy}
+};
+static constexpr auto fuzz_modes = loyopt::MakeChoiceSet(fuzz_mode_choices);
+
+struct FuzzOptions
+{
+    loyopt::Option<bool>                 a{"-a", "--alpha"};
+    loyopt::Option<bool>                 b{"-b", "--alpha-beta"};
+    loyopt::Option<bool>                 c{"-c"};
+    loyopt::Option<std::string>          s{"", "-s", "--str"};
+    loyopt::Option<int32_t>              i{0, -1000, 1000, "-i", "--int32"};
+    loyopt::Option<uint32_t>             u{0, 16, "-u", "--uint32"};
+    loyopt::Option<int64_t>              k{0, "-k", "--int64-bytes"};
+    loyopt::Option<int64_t>              t{0, "--int64-ms"};
+    loyopt::Option<float>                f{0.0f, -1e6f, 1e6f, "-f", "--float"};
+    loyopt::Option<double>               d{0.0, "-d", "--double"};
+    loyopt::Option<std::vector<int32_t>> l{{}, "-l", "--list"};
+    loyopt::Option<std::vector<double>>  g{{}, "--list-double"};
+    loyopt::Option<FuzzMode>             m{FuzzMode::Safe, fuzz_modes, "-m", "--mode"};
+    std::vector<loyopt::OptionBase *> all{&a, &b, &c, &s, &i, &u, &k, &t, &f, &d, &l, &g, &m};
+    FuzzOptions()
+    {
+        k.SetUnit(loyopt::OptionBase::Bytes);
+        t.SetUnit(loyopt::OptionBase::Milliseconds);
+        l.SetParallel(256, 64, 2);  // long lists in fuzz inputs take the parallel path.
+    }
+};
+
+enum class GenKind
+{
+    HugeArgv,       // many short args: names, prefixes of names, values, "--name=value".
+    MergedFlags,    // long merged short flags "-abc...", with value options and unknown chars.
+    LongNumbers,    // long numeric literals, with signs, "0x", exponents and unit suffixes.
+    Mixed           // all of above.
+};
+
+// splitmix64, deterministic across platforms.
+struct FuzzRandom
+{
+    uint64_t state;
+    explicit FuzzRandom(uint64_t seed) : state(seed) {}
+    uint64_t Next()
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    size_t Below(size_t n) { return n ? (size_t)(Next() % n) : 0; }
+    template<size_t N>
+    const char *Pick(const char *const (&strs)[N]) { return strs[Below(N)]; }
+};
+
+inline void gen_arg(std::string &out, const std::string &arg)
+{
+    out += arg;
+    out.push_back('\0');
+}
+
+inline void gen_digits(std::string &out, FuzzRandom &rnd, size_t n, bool hex = false)
+{
+    static const char digits[] = "0123456789abcdefABCDEF";
+    for(size_t j = 0; j < n; j++)
+        out.push_back(digits[rnd.Below(hex ? 22 : 10)]);
+}
+
+// a numeric literal of about n chars.
+inline std::string gen_number(FuzzRandom &rnd, size_t n)
+{
+    static const char *const prefixes[] = {"", "-", "+", "0x", "-0x", "0", ".", "-."};
+    static const char *const suffixes[] =
+    {
+        "", "", "K", "KiB", "MB", "GiB", "ms", "s", "m", "h", "us", "ns", "e308", "e-400", ".5", "x"
+    };
+    std::string num = rnd.Pick(prefixes);
+    gen_digits(num, rnd, n ? n : 1, num.find('x') != std::string::npos);
+    if(rnd.Below(4) == 0)
+    {
+        num.push_back('.');
+        gen_digits(num, rnd, rnd.Below(n + 1));
+    }
+    num += rnd.Pick(suffixes);
+    return num;
+}
+
+// append args of kind of about n bytes to out.
+inline void gen_args(std::string &out, GenKind kind, size_t n, FuzzRandom &rnd)
+{
+    static const char *const names[] =
+    {
+        "-a", "-b", "-c", "-s", "-i", "-u", "-k", "-f", "-d", "-l", "-m", "-x", "-", "--",
+        "--alpha", "--alpha-beta", "--al", "--alpha-", "--str", "--int32", "--uint32",
+        "--int64", "--int64-bytes", "--int64-ms", "--float", "--double", "--list",
+        "--list-double", "--list-", "--mode", "--unknown"
+    };
+    static const char *const values[] = {"fast", "safe", "fancy", "", " ", "=", ",", "1,2,3", "0x7fffffff"};
+    static const char flags[] = "abcsiukfdlmxz0-=";
+    const size_t end = out.size() + n;
+    switch(kind)
+    {
+    case GenKind::HugeArgv:
+        while(out.size() < end)
+        {
+            std::string arg = rnd.Pick(names);
+            const size_t r = rnd.Below(8);
+            if(r == 0)
+                arg = arg + "=" + gen_number(rnd, rnd.Below(8));
+            else if(r == 1)
+                arg = rnd.Pick(values);
+            else if(r == 2)
+                arg = gen_number(rnd, rnd.Below(12));
+            gen_arg(out, arg);
+        }
+        break;
+    case GenKind::MergedFlags:
+        while(out.size() < end)
+        {
+            std::string arg = "-";
+            const size_t len = 1 + rnd.Below(end - out.size());
+            for(size_t j = 0; j < len; j++)
+                arg.push_back(rnd.Below(4) ? "abc"[rnd.Below(3)] : flags[rnd.Below(sizeof(flags) - 1)]);
+            gen_arg(out, arg);
+        }
+        break;
+    case GenKind::LongNumbers:
+        while(out.size() < end)
+        {
+            const size_t len = 1 + rnd.Below(end - out.size());
+            if(rnd.Below(3) == 0)
+            {   // a long list.
+                gen_arg(out, rnd.Below(2) ? "--list" : "--list-double");
+                std::string list;
+                while(list.size() < len)
+                {
+                    list += gen_number(rnd, 1 + rnd.Below(12));
+                    list.push_back(rnd.Below(16) ? ',' : ' ');
+                }
+                gen_arg(out, list);
+            }
+            else
+            {
+                gen_arg(out, rnd.Pick(names));
+                gen_arg(out, gen_number(rnd, len));
+            }
+        }
+        break;
+    case GenKind::Mixed:
+        while(out.size() < end)
+            gen_args(out, (GenKind)rnd.Below(3), 1 + rnd.Below(end - out.size()), rnd);
+        break;
+    }
+}
+
+// return args of kind of about n bytes, each terminated by '\0', deterministic for seed.
+inline std::string GenerateArgv(GenKind kind, size_t n, uint64_t seed)
+{
+    FuzzRandom rnd(seed);
+    std::string out;
+    out.reserve(n + 64);
+    gen_args(out, kind, n, rnd);
+    return out;
+}
+
+// return argv of a program name and args in [data, data + size) split at '\0',
+// pointing into storage, which is data with a '\0' appended.
+inline std::vector<const char *> ArgvOf(const char *prog, const char *data, size_t size, std::string &storage)
+{
+    storage.assign(data, size);
+    storage.push_back('\0');
+    std::vector<const char *> argv{prog};
+    for(size_t p = 0; p < size; p += strlen(&storage[p]) + 1)
+        argv.push_back(&storage[p]);
+    return argv;
+}
+
+#endif
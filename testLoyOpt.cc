@@ -1,4 +1,8 @@
+#define LOYOPTION_VERBOSE true     // print debug info of parsing.
 #include "LoyOpt.h"
+#include "LoyOptHelp.h"
+
+#include <sstream>
 
 using namespace std;
 
@@ -58,6 +62,10 @@ void init_opt_helps()
 
 int main(int argc, const char *argv[])
 {
+    // answer shell completion, "--complete ..." or "--complete-script bash", before anything else.
+    if(OptionParser::Complete(argc, argv, options))
+        return 0;
+
     cout << "Hello from LoyOpt Test." << endl;
 
     cout << "Defining a OptionParser," << endl;
@@ -66,9 +74,9 @@ int main(int argc, const char *argv[])
 
     cout << endl << "Parsing for all Options," << endl;
     cout << "with LOYOPTION_VERBOSE = true, status and value of each option will be shown below." << endl;
+    op.ParseAll(options);
     for(OptionBase *o : options)
     {
-        op.Parse(*o);
         switch (o->GetStatus())
         {
         case OptionBase::ClampedMin :
@@ -85,15 +93,14 @@ int main(int argc, const char *argv[])
     }
 
     cout << endl << "See if any arg has not been parsed." << endl;
-    const string &first_uparsed_arg = op.FirstUnparsedArg();
+    string_view first_uparsed_arg = op.FirstUnparsedArg();
     if(!first_uparsed_arg.empty())
         cout << "Unrecognised option \"" << first_uparsed_arg << "\" found, please chek your command line." << endl;
-    vector<string> unparsed_args = op.GetAllUnparsedArgs();
-    if(!unparsed_args.empty())
+    if(op.NumUnparsedArgs())
     {
-        cout << "There is/are " << unparsed_args.size() << " unparsed args." << endl;
+        cout << "There is/are " << op.NumUnparsedArgs() << " unparsed args." << endl;
     }
-    for(const string &s : unparsed_args)
+    for(string_view s : op.UnparsedArgs())
     {
         cout << "     " << s << endl;
     }
@@ -155,24 +162,24 @@ int main(int argc, const char *argv[])
 
 // Parsing for all Options,
 // with LOYOPTION_VERBOSE = true, status and value of each option will be shown below.
-// [debug info] OptionParser::Parse() : [Parsed Success] -?, --help = True
-// [debug info] OptionParser::Parse() : [Parsed Success] -a = True
-// [debug info] OptionParser::Parse() : [Parsed Success] -b, --bool_b = True
-// [debug info] OptionParser::Parse() : [Parsed Success] -c = "~/Documents/Work Files/foo.txt"
-// [debug info] OptionParser::Parse() : [Opt Not Found ] -d, --string_d = "a string for d"
-// [debug info] OptionParser::Parse() : [Opt Not Found ] -e = 0
-// [debug info] OptionParser::Parse() : [Parsed Success] --int32_f = 123456
-// [debug info] OptionParser::Parse() : [Clamped To Max] -g, --int32_g = 100
+// [debug info] OptionParser::ParseAll() : [Parsed Success] -?, --help = True
+// [debug info] OptionParser::ParseAll() : [Parsed Success] -a = True
+// [debug info] OptionParser::ParseAll() : [Parsed Success] -b, --bool_b = True
+// [debug info] OptionParser::ParseAll() : [Parsed Success] -c = "~/Documents/Work Files/foo.txt"
+// [debug info] OptionParser::ParseAll() : [Opt Not Found ] -d, --string_d = "a string for d"
+// [debug info] OptionParser::ParseAll() : [Opt Not Found ] -e = 0
+// [debug info] OptionParser::ParseAll() : [Parsed Success] --int32_f = 123456
+// [debug info] OptionParser::ParseAll() : [Clamped To Max] -g, --int32_g = 100
+// [debug info] OptionParser::ParseAll() : [Parsed Success] -h, --int32_h = 0xa5a5
+// [debug info] OptionParser::ParseAll() : [Value Invalid ] --int32_i = 0x0
+// [debug info] OptionParser::ParseAll() : [Clamped To Min] -j, --uint32_j = 100
+// [debug info] OptionParser::ParseAll() : [Opt Not Found ] --int64_k = 0
+// [debug info] OptionParser::ParseAll() : [Parsed Success] -l, --float_l = 3.141600
+// [debug info] OptionParser::ParseAll() : [Opt Not Found ] --float_m = 0.000000
+// [debug info] OptionParser::ParseAll() : [Value NotFound] -n, --double_n = 0.000000
 //     option value for "-g" is out of range, has been clampped to 100.
-// [debug info] OptionParser::Parse() : [Parsed Success] -h, --int32_h = 0xa5a5
-// [debug info] OptionParser::Parse() : [Value Invalid ] --int32_i = 0x0
 //     option value for "--int32_i" is invalid.
-// [debug info] OptionParser::Parse() : [Clamped To Min] -j, --uint32_j = 100
 //     option value for "-j" is out of range, has been clampped to 100.
-// [debug info] OptionParser::Parse() : [Opt Not Found ] --int64_k = 0
-// [debug info] OptionParser::Parse() : [Parsed Success] -l, --float_l = 3.141600
-// [debug info] OptionParser::Parse() : [Opt Not Found ] --float_m = 0.000000
-// [debug info] OptionParser::Parse() : [Value NotFound] -n, --double_n = 0.000000
 
 // See if any arg has not been parsed.
 // Unrecognised option "--string_d_typo" found, please chek your command line.
@@ -0,0 +1,920 @@
+#define LOYOPTION_OBSERVER true
+#include "LoyOpt.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// ==== unit_loyopt ===
+//
+// Unit tests of behaviors of LoyOpt.h, each test_*() a function of a feature or a fixed bug,
+// run by ctest, exits with 1 if any CHECK() failed.
+
+static int num_checks = 0, num_failed = 0;
+
+#define CHECK(cond) \
+    do { num_checks++; if(!(cond)) { num_failed++; printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); } } while(0)
+
+static void test_numeric()
+{
+    Option<int32_t>  i(0, -100, 100, "-i");
+    Option<uint32_t> h(0, 16, "-h");
+    Option<int64_t>  k(0, "-k");
+    Option<float>    f(0.0f, "-f");
+    Option<double>   d(0.0, "-d");
+    vector<OptionBase *> opts{&i, &h, &k, &f, &d};
+    const char *args[] = {"p", "-i", "1000", "-h", "0xa5A5", "-k", "-9223372036854775808", "-f", "1e39", "-d", "2.5"};
+    OptionParser op((int)size(args), args);
+    op.ParseAll(opts);
+    CHECK(i.GetStatus() == OptionBase::ClampedMax && i.Value() == 100);
+    CHECK(h.GetStatus() == OptionBase::Parsed && h.Value() == 0xa5a5);
+    CHECK(k.GetStatus() == OptionBase::Parsed && k.Value() == INT64_MIN);
+    CHECK(f.GetStatus() == OptionBase::ValueOverflow);
+    CHECK(d.GetStatus() == OptionBase::Parsed && d.Value() == 2.5);
+    CHECK(op.NumUnparsedArgs() == 0);
+}
+
+static void test_merged_flags()
+{
+    Option<bool>   a("-a"), b("-b");
+    Option<string> c("", "-c");
+    vector<OptionBase *> opts{&a, &b, &c};
+    const char *args[] = {"p", "-abcvalue"};
+    OptionParser op((int)size(args), args);
+    op.ParseAll(opts);
+    CHECK(a.Value() && b.Value() && c.Value() == "value");
+    CHECK(op.NumUnparsedArgs() == 0);
+}
+
+static void test_units()
+{
+    Option<int64_t> k(0, "-k"), t(0, "-t");
+    k.SetUnit(OptionBase::Bytes);
+    t.SetUnit(OptionBase::Milliseconds);
+    vector<OptionBase *> opts{&k, &t};
+    const char *args[] = {"p", "-k", "64KiB", "-t", "2s"};
+    OptionParser op((int)size(args), args);
+    op.ParseAll(opts);
+    CHECK(k.Value() == 64 * 1024);
+    CHECK(t.Value() == 2000);
+}
+
+static void test_format_and_blob()
+{
+    Option<int32_t>         i(7, "-i");
+    Option<string>          s("abc", "-s");
+    Option<vector<int32_t>> l({1, 2}, "-l");
+    vector<OptionBase *> opts{&i, &s, &l};
+    const char *args[] = {"p", "-i", "42", "-l", "3,4,5"};
+    OptionParser op((int)size(args), args);
+    op.ParseAll(opts);
+    string v;
+    l.AppendValueTo(v);
+    CHECK(v == "3,4,5");
+    char buf[2];
+    CHECK(i.FormatValue(buf, buf + sizeof(buf)) == buf + 2);
+    CHECK(!s.FormatValue(buf, buf + sizeof(buf)));
+
+    Option<int32_t>         i2(0, "-i");
+    Option<string>          s2("", "-s");
+    Option<vector<int32_t>> l2({}, "-l");
+    vector<OptionBase *> opts2{&i2, &s2, &l2};
+    CHECK(OptionBlob::Load(opts2, OptionBlob::Save(opts)) == OptionBlob::Loaded);
+    CHECK(i2.Value() == 42 && s2.Value() == "abc" && l2.Value() == l.Value());
+}
+
+static void test_stream_as_parse_all()
+{
+    Option<bool>    a("-a"), b("-b");
+    Option<string>  s("", "--str");
+    Option<int32_t> i(0, "--int");
+    vector<OptionBase *> opts{&a, &b, &s, &i};
+    const char input[] = "-ab --str \"x y\" --int=12 rest";
+    OptionStream os(opts);
+    for(const char *p = input; *p; p++)
+        os.Feed(p, 1);
+    CHECK(os.Finish() == 4);
+    CHECK(a.Value() && b.Value() && s.Value() == "x y" && i.Value() == 12);
+    CHECK(os.NumUnparsedArgs() == 1 && os.FirstUnparsedArg() == "rest");
+}
+
+// Parse() in order of 1st occurrences has the same results as ParseAll(),
+// bool "-a" and "-b" are never taken from an attached value, such as "-cab".
+static void test_parse_as_parse_all()
+{
+    const vector<vector<const char *>> cases =
+    {
+        {"p", "-cab"}, {"p", "-acb"}, {"p", "-ca", "-b"}, {"p", "-c", "-ab"}, {"p", "-bca", "-a"}
+    };
+    for(vector<const char *> args : cases)
+    {
+        Option<bool>   a1("-a"), b1("-b"), a2("-a"), b2("-b");
+        Option<string> c1("", "-c"), c2("", "-c");
+        OptionParser op1((int)args.size(), args.data());
+        op1.ParseAll({&a1, &b1, &c1});
+        OptionParser op2((int)args.size(), args.data());
+        for(OptionBase *opt : vector<OptionBase *>{&c2, &a2, &b2})
+            op2.Parse(*opt);
+        CHECK(a1.Value() == a2.Value() && b1.Value() == b2.Value() && c1.Value() == c2.Value());
+        CHECK(op1.NumUnparsedArgs() == op2.NumUnparsedArgs());
+    }
+    Option<bool>   a("-a"), b("-b");
+    Option<string> c("", "-c");
+    const char *args[] = {"p", "-cab"};
+    OptionParser op((int)size(args), args);
+    op.Parse(c);
+    CHECK(op.Parse(a) == OptionBase::NotFound && op.Parse(b) == OptionBase::NotFound);
+    CHECK(c.Value() == "ab" && !a.Value() && !b.Value());
+}
+
+// an arg split but not parsed at all is unparsed as the original one.
+static void test_unparsed_split_args()
+{
+    Option<bool>    a("-a");
+    Option<int32_t> n(0, "--num");
+    vector<OptionBase *> opts{&a, &n};
+    const char *args[] = {"p", "--x=y", "-xyz", "-ax", "--num=1", "rest"};
+    OptionParser op((int)size(args), args);
+    op.ParseAll(opts);
+    vector<string> unparsed;
+    for(string_view arg : op.UnparsedArgs())
+        unparsed.emplace_back(arg);
+    CHECK((unparsed == vector<string>{"--x=y", "-xyz", "-x", "rest"}));
+    CHECK(op.NumUnparsedArgs() == 4 && op.FirstUnparsedArg() == "--x=y");
+    CHECK(op.GetAllUnparsedArgs() == unparsed);
+
+    OptionStream os(opts);
+    const char input[] = "--x=y -xyz -ax --num=1 rest";
+    os.Feed(input, sizeof(input) - 1);
+    os.Finish();
+    CHECK(os.NumUnparsedArgs() == 4 && os.FirstUnparsedArg() == "--x=y");
+}
+
+// HelpText() is rendered again after help lines or unit changed.
+static void test_help_text_cache()
+{
+    Option<int64_t> k(0, "-k", "--size");
+    k.HelpLines.push_back("size of a buffer.");
+    const string before = k.HelpText();
+    CHECK(&k.HelpText() == &k.HelpText() && k.HelpText() == before);
+    k.SetUnit(OptionBase::Bytes);
+    CHECK(k.HelpText() != before && k.HelpText().find("in bytes") != string::npos);
+    k.HelpLines.push_back("a second line.");
+    CHECK(k.HelpText().find("a second line.") != string::npos);
+    k.HelpLines.clear();
+    CHECK(k.HelpText().find("size of a buffer.") == string::npos);
+}
+
+// a unit suffix follows all digits in the base, optionally after '_'.
+static void test_hex_units()
+{
+    const struct { const char *arg; int base; int64_t val; OptionBase::Status status; } cases[] =
+    {
+        {"0x1B",   16, 27,            OptionBase::Parsed},
+        {"0x1_B",  16, 1,             OptionBase::Parsed},
+        {"1B",     16, 27,            OptionBase::Parsed},
+        {"0x10K",  16, 16 << 10,      OptionBase::Parsed},
+        {"0x2_E",  16, 2ll << 60,     OptionBase::Parsed},
+        {"0x2E",   16, 0x2e,          OptionBase::Parsed},
+        {"0x1_KiB",16, 1 << 10,       OptionBase::Parsed},
+        {"64K",    10, 64 << 10,      OptionBase::Parsed},
+        {"64_MB",  10, 64000000,      OptionBase::Parsed},
+        {"1.5K",   10, 0,             OptionBase::ValueInvalid},
+        {"5_",     10, 0,             OptionBase::ValueInvalid},
+        {"0x1_Q",  16, 0,             OptionBase::ValueInvalid},
+    };
+    for(const auto &c : cases)
+    {
+        Option<int64_t> k(0, c.base, "-k");
+        k.SetUnit(OptionBase::Bytes);
+        const char *args[] = {"p", "-k", c.arg};
+        OptionParser op((int)size(args), args);
+        CHECK(op.Parse(k) == c.status);
+        CHECK(k.Value() == c.val);
+        Option<vector<int64_t>> l({}, c.base, "-l");
+        l.SetUnit(OptionBase::Bytes);
+        const char *list_args[] = {"p", "-l", c.arg};
+        OptionParser list_op((int)size(list_args), list_args);
+        list_op.Parse(l);
+        CHECK(c.status != OptionBase::Parsed || l.Value() == vector<int64_t>{c.val});
+    }
+}
+
+// floating point literals too small are 0 or denormal, like strtod(), too large are ValueOverflow.
+template<typename T>
+static void check_float_literal(const char *arg, OptionBase::Status status, T val)
+{
+    Option<T> f(1, "-f");
+    const char *args[] = {"p", "-f", arg};
+    OptionParser op((int)size(args), args);
+    CHECK(op.Parse(f) == status);
+    CHECK(status != OptionBase::Parsed || (f.Value() == val && signbit(f.Value()) == signbit(val)));
+}
+
+static void test_float_limits()
+{
+    check_float_literal<float>("1e-50", OptionBase::Parsed, 0.0f);
+    check_float_literal<float>("-1e-50", OptionBase::Parsed, -0.0f);
+    check_float_literal<float>("1e-45", OptionBase::Parsed, numeric_limits<float>::denorm_min());
+    check_float_literal<float>("1.17549435e-38", OptionBase::Parsed, numeric_limits<float>::min());
+    check_float_literal<float>("3.40282347e38", OptionBase::Parsed, numeric_limits<float>::max());
+    check_float_literal<float>("1e39", OptionBase::ValueOverflow, 0.0f);
+    check_float_literal<float>("-1e39", OptionBase::ValueOverflow, 0.0f);
+    check_float_literal<float>("0.00001e-45", OptionBase::Parsed, 0.0f);
+    check_float_literal<float>("100000e-55", OptionBase::Parsed, 0.0f);
+    check_float_literal<float>("0x1p-200", OptionBase::Parsed, 0.0f);
+    check_float_literal<float>("0x1p200", OptionBase::ValueOverflow, 0.0f);
+    check_float_literal<double>("1e-400", OptionBase::Parsed, 0.0);
+    check_float_literal<double>("2e-324", OptionBase::Parsed, 0.0);
+    check_float_literal<double>("4.9e-324", OptionBase::Parsed, numeric_limits<double>::denorm_min());
+    check_float_literal<double>("2.2250738585072014e-308", OptionBase::Parsed, numeric_limits<double>::min());
+    check_float_literal<double>("1.7976931348623157e308", OptionBase::Parsed, numeric_limits<double>::max());
+    check_float_literal<double>("1e309", OptionBase::ValueOverflow, 0.0);
+    check_float_literal<double>("-0x1p-2000", OptionBase::Parsed, -0.0);
+    check_float_literal<double>("1e-99999999999999999999", OptionBase::Parsed, 0.0);
+    check_float_literal<double>("1e99999999999999999999", OptionBase::ValueOverflow, 0.0);
+}
+
+// names are matched exactly by default, and by unique prefixes after SetPrefixMatch(true).
+static void test_prefix_match()
+{
+    Option<int32_t> a(0, "--alpha"), b(0, "--alpine");
+    vector<OptionBase *> opts{&a, &b};
+    const char *args[] = {"p", "--alph", "1", "--al", "2"};
+    OptionParser op((int)size(args), args);
+    CHECK(op.ParseAll(opts) == 0);
+    CHECK(a.GetStatus() == OptionBase::NotFound && b.GetStatus() == OptionBase::NotFound);
+    CHECK(op.NumUnparsedArgs() == 4);
+    OptionParser op2((int)size(args), args);
+    op2.SetPrefixMatch(true);
+    CHECK(op2.ParseAll(opts) == 1);
+    CHECK(a.GetStatus() == OptionBase::Parsed && a.Value() == 1);
+    CHECK(b.GetStatus() == OptionBase::NameAmbiguous && op2.FirstUnparsedArg() == "--al");
+}
+
+// options an ambiguous prefix may refer to are still taken from environment variables.
+static void test_ambiguous_fallback()
+{
+    Option<int32_t> a(0, "--alpha"), b(0, "--alpine");
+    vector<OptionBase *> opts{&a, &b};
+    const char *args[] = {"p", "--al", "1"};
+    const char *envp[] = {"T_ALPHA=5", nullptr};
+    OptionParser op((int)size(args), args);
+    op.SetPrefixMatch(true);
+    CHECK(op.LoadEnv("T_", envp) == 1);
+    CHECK(op.ParseAll(opts) == 0);
+    CHECK(a.GetStatus() == OptionBase::Parsed && a.GetSource() == OptionBase::FromEnv && a.Value() == 5);
+    CHECK(b.GetStatus() == OptionBase::NameAmbiguous && b.GetSource() == OptionBase::FromDefault);
+    CHECK(op.FirstUnparsedArg() == "--al" && op.NumUnparsedArgs() == 2);
+}
+
+// HelpLines assigned as a whole, and interned in the pool of a MemoryScope.
+static void test_help_lines_pool()
+{
+    Option<int32_t> i(0, "-i");
+    i.HelpLines = {"line 1.", "line 2."};
+    CHECK(i.HelpLines.size() == 2 && i.HelpLines[1] == "line 2.");
+    i.HelpLines = {"only line."};
+    CHECK(i.HelpLines.size() == 1 && i.HelpText().find("only line.") != string::npos);
+
+    alignas(max_align_t) static char buf[64 << 10];
+    pmr::monotonic_buffer_resource arena(buf, sizeof(buf), pmr::null_memory_resource());
+    const size_t shared_strings = StringPool::Shared().NumStrings();
+    {
+        StringPool pool(&arena);
+        MemoryScope scope(&arena, &pool);
+        Option<int32_t> a(0, "--scoped-name-a"), b(0, "--scoped-name-a");
+        a.HelpLines = {"a scoped help line."};
+        b.HelpLines.push_back("a scoped help line.");
+        CHECK(a.GetName().data() == b.GetName().data());
+        CHECK(a.HelpLines.begin() == b.HelpLines.begin());
+        CHECK(pool.NumStrings() == 2 && pool.NumArrays() == 1);
+        CHECK(a.GetName().data() >= buf && a.GetName().data() < buf + sizeof(buf));
+        {
+            MemoryScope inner(nullptr);     // keeps the pool of the enclosing scope.
+            Option<int32_t> c(0, "--scoped-name-c");
+            CHECK(pool.NumStrings() == 3);
+        }
+    }
+    CHECK(StringPool::Shared().NumStrings() == shared_strings);
+}
+
+// a snapshot held by a reader is never freed, retired ones are freed once released.
+static void test_live_options_reclaim()
+{
+    Option<int32_t> n(0, "-n");
+    LiveOptions live({&n}, 4);
+    const char *args1[] = {"p", "-n", "1"};
+    const char *args2[] = {"p", "-n", "2"};
+    LiveOptions::SnapshotRef held = live.Acquire();
+    CHECK(held->Generation() == 0);
+    live.Reload((int)size(args1), args1);
+    live.Reload((int)size(args2), args2);
+    CHECK(live.NumRetired() == 2);  // generation 0 is held, so 1 retired after it too.
+    CHECK(held->Get(n).Value() == 0);
+    {
+        LiveOptions::SnapshotRef snap = live.Acquire();
+        CHECK(snap->Generation() == 2 && snap->Get(n).Value() == 2);
+    }
+    held.Release();
+    CHECK(live.Reclaim() == 2 && live.NumRetired() == 0);
+    for(int k = 0; k < 100; k++)
+        live.Reload((int)size(args1), args1);
+    CHECK(live.NumRetired() == 0);  // reclaimed by Publish() without readers.
+
+    // readers in threads check a snapshot stays intact while held, across reloads,
+    // value of generation g is g % 1000 from here on.
+    const uint64_t first = live.Generation() + 1;
+    atomic<bool> stop{false};
+    atomic<size_t> num_bad{0}, num_read{0};
+    vector<thread> readers;
+    for(int t = 0; t < 3; t++)
+    {
+        readers.emplace_back([&]
+        {
+            while(!stop.load())
+            {
+                LiveOptions::SnapshotRef snap = live.Acquire();
+                if(snap->Generation() < first)
+                    continue;
+                const int32_t v = snap->Get(n).Value();
+                for(int k = 0; k < 50; k++)
+                    num_bad += snap->Get(n).Value() != v || (uint64_t)v != snap->Generation() % 1000;
+                num_read++;
+            }
+        });
+    }
+    vector<string> values;
+    for(int k = 0; k < 1000; k++)
+        values.push_back(to_string(k));
+    for(uint64_t k = first; k < first + 3000 || num_read < 1000; k++)
+    {
+        const char *args[] = {"p", "-n", values[k % 1000].c_str()};
+        live.Reload((int)size(args), args);
+    }
+    stop = true;
+    for(thread &t : readers)
+        t.join();
+    CHECK(num_bad == 0);
+    live.Reclaim();
+    CHECK(live.NumRetired() == 0);
+}
+
+// options reused across Reparse(), and options re-created at the same address with other names.
+static void test_reparse_options()
+{
+    Option<int32_t> n(0, "-n");
+    Option<bool>    v("-v");
+    vector<OptionBase *> opts{&n, &v};
+    const char *args1[] = {"p", "-n", "1", "-v"};
+    const char *args2[] = {"p", "-n", "2"};
+    OptionParser op((int)size(args1), args1);
+    op.ParseAll(opts);
+    CHECK(n.Value() == 1 && v.Value());
+    for(OptionBase *opt : opts)
+        opt->Reset();
+    op.Reparse((int)size(args2), args2);
+    CHECK(op.ParseAll(opts) == 1);
+    CHECK(n.Value() == 2 && !v.Value() && v.GetStatus() == OptionBase::NotFound);
+
+    optional<Option<int32_t>> slot;
+    slot.emplace(0, "--x");
+    vector<OptionBase *> one{&*slot};
+    const char *args3[] = {"p", "--x", "3"};
+    const char *args4[] = {"p", "--y", "4"};
+    op.Reparse((int)size(args3), args3);
+    op.ParseAll(one);
+    CHECK(slot->Value() == 3);
+    slot.reset();
+    slot.emplace(0, "--y");     // same address as the one destroyed.
+    CHECK(one[0] == &*slot);
+    op.Reparse((int)size(args4), args4);
+    CHECK(op.ParseAll(one) == 1);
+    CHECK(slot->GetStatus() == OptionBase::Parsed && slot->Value() == 4 && op.NumUnparsedArgs() == 0);
+}
+
+// bool options from environment variables and config files, true, false or invalid by the value.
+static void test_env_bool()
+{
+    const char *args[] = {"p"};
+    const char *envp[] = {"T_A=false", "T_B=ON", "T_C=", "T_D=maybe", "T_E=1", nullptr};
+    Option<bool> a("--a"), b("--b"), c("--c"), d("--d"), e("--e");
+    vector<OptionBase *> opts{&a, &b, &c, &d, &e};
+    a.SetValue(true);
+    c.SetValue(true);
+    d.SetValue(true);
+    OptionParser op((int)size(args), args);
+    CHECK(op.LoadEnv("T_", envp) == 5);
+    op.ParseAll(opts);
+    CHECK(a.GetStatus() == OptionBase::Parsed && !a.Value() && a.GetSource() == OptionBase::FromEnv);
+    CHECK(b.GetStatus() == OptionBase::Parsed && b.Value());
+    CHECK(c.GetStatus() == OptionBase::Parsed && !c.Value());
+    CHECK(d.GetStatus() == OptionBase::ValueInvalid && d.Value());
+    CHECK(e.GetStatus() == OptionBase::Parsed && e.Value());
+    a.SetValue(true);
+    CHECK(op.Parse(a) == OptionBase::Parsed && !a.Value());
+}
+
+#if(LOYOPTION_OBSERVER)
+// events of each parser go to it's own observer, and the default one is of parsers constructed after.
+struct EventLog
+{
+    vector<OptionEvent::Kind> kinds;
+    vector<string> args;
+};
+static void log_event(const OptionEvent &ev, void *ctx)
+{
+    EventLog &log = *(EventLog *)ctx;
+    log.kinds.push_back(ev.kind);
+    log.args.emplace_back(ev.arg);
+}
+static void test_observers()
+{
+    Option<int32_t> n(0, 0, 10, "-n");
+    Option<bool>    v("-v");
+    vector<OptionBase *> opts{&n, &v};
+    const char *args1[] = {"p", "-n", "20", "x"};
+    const char *args2[] = {"p", "-v"};
+    EventLog log1, log2, log_default;
+    OptionParser op1((int)size(args1), args1);
+    OptionParser op2((int)size(args2), args2);
+    op1.SetObserver(&log_event, &log1);
+    op2.SetObserver(&log_event, &log2);
+    op1.ParseAll(opts);
+    op2.Parse(v);
+    using K = OptionEvent;
+    CHECK((log1.kinds == vector<OptionEvent::Kind>{K::OptionMatched, K::ValueClamped, K::OptionParsed,
+                                                   K::OptionParsed, K::UnparsedArg}));
+    CHECK(log1.args[0] == "-n" && log1.args[1] == "20" && log1.args[4] == "x");
+    CHECK((log2.kinds == vector<OptionEvent::Kind>{K::OptionMatched, K::OptionParsed}));
+    op1.Reparse((int)size(args2), args2);   // tokenized with the observer of op1.
+    CHECK(log1.kinds.size() == 7 && log1.kinds[5] == K::ArgTokenized && log1.args[6] == "-v");
+
+    OptionParser::SetDefaultObserver(&log_event, &log_default);
+    OptionParser op3((int)size(args2), args2);
+    OptionParser::SetDefaultObserver(nullptr);
+    op3.Parse(v);
+    CHECK(log_default.kinds.size() == 4 && log_default.kinds[0] == K::ArgTokenized);
+    CHECK(log1.kinds.size() == 7 && log2.kinds.size() == 2);
+}
+#endif
+
+// a literal out of range of the type is clamped into a narrower range of the option, as strtoll()
+// of the baseline, or ValueOverflow, and leading white spaces are skipped.
+static void test_overflow_clamp()
+{
+    Option<int32_t> r(7, 0, 100, "-r"), n(7, "-n"), m(7, -5, 100, "-m");
+    Option<float>   f(0.0f, -1e6f, 1e6f, "-f");
+    Option<int64_t> k(0, "-k");
+    k.SetUnit(OptionBase::Bytes);
+    vector<OptionBase *> opts{&r, &n, &m, &f, &k};
+    const char *args[] = {"p", "-r", "3000000000", "-n", "3000000000", "-m", "-3000000000", "-f", "1e39", "-k", " 64K"};
+    OptionParser op((int)size(args), args);
+    op.ParseAll(opts);
+    CHECK(r.GetStatus() == OptionBase::ClampedMax && r.Value() == 100);
+    CHECK(n.GetStatus() == OptionBase::ValueOverflow && n.Value() == 7);
+    CHECK(m.GetStatus() == OptionBase::ClampedMin && m.Value() == -5);
+    CHECK(f.GetStatus() == OptionBase::ClampedMax && f.Value() == 1e6f);
+    CHECK(k.GetStatus() == OptionBase::Parsed && k.Value() == 65536);
+
+    const char *spaced[] = {"p", "-r", " 5", "-n", "\t-6", "-m", "5 "};
+    for(OptionBase *opt : opts)
+        opt->Reset();
+    OptionParser op2((int)size(spaced), spaced);
+    op2.ParseAll(opts);
+    CHECK(r.GetStatus() == OptionBase::Parsed && r.Value() == 5);
+    CHECK(n.GetStatus() == OptionBase::Parsed && n.Value() == -6);
+    CHECK(m.GetStatus() == OptionBase::ValueInvalid && m.Value() == 7);
+}
+
+// global options are parsed only before the subcommand name, the rest goes to the subcommand.
+static int32_t ingest_level;
+static string ingest_file;
+static int ingest_main(OptionParser &op)
+{
+    Option<string> file("", "-f", "--file");
+    Option<int32_t> level(0, 0, 9, "-l");
+    vector<OptionBase *> opts{&file, &level};
+    op.ParseAll(opts);
+    ingest_file = file.Value();
+    ingest_level = level.Value();
+    return (int)op.NumUnparsedArgs();
+}
+static void test_command_dispatch()
+{
+    static const CommandSet commands
+    {
+        { "ingest", &ingest_main, "ingest data files." }
+    };
+    Option<string> file("", "-f");
+    Option<bool> verbose("-v");
+    vector<OptionBase *> globals{&file, &verbose};
+    const char *args[] = {"p", "-x", "-f", "ingest", "-v", "ingest", "-f", "a.txt", "-l5", "-y"};
+    OptionParser op((int)size(args), args);
+    int rtn = -1;
+    CHECK(commands.Dispatch(op, globals, rtn) == &commands.All()[0] && rtn == 1);
+    CHECK(file.Value() == "ingest" && verbose.Value());
+    CHECK(ingest_file == "a.txt" && ingest_level == 5);
+    CHECK(op.NumUnparsedArgs() == 1 && op.FirstUnparsedArg() == "-x");
+    const char *args2[] = {"p", "-z", "compact"};
+    OptionParser op2((int)size(args2), args2);
+    rtn = -1;
+    CHECK(!commands.Dispatch(op2, globals, rtn) && rtn == -1);
+    const char *args3[] = {"p", "--name=x", "-q", "ingest"};
+    OptionParser op3((int)size(args3), args3);
+    CHECK(commands.Dispatch(op3, rtn) && rtn == 0 && op3.NumUnparsedArgs() == 2);
+}
+
+// help text lists the unit suffixes accepted by parsing.
+static void test_unit_help()
+{
+    Option<int64_t> k(0, "-k"), t(0, "-t");
+    k.SetUnit(OptionBase::Bytes);
+    t.SetUnit(OptionBase::Seconds);
+    CHECK(k.HelpText().find("B, K/Ki/KiB, M/Mi/MiB, G/Gi/GiB, T/Ti/TiB, P/Pi/PiB, E/Ei/EiB (1024 based) "
+            "or KB/kB, MB, GB, TB, PB, EB") != string::npos);
+    CHECK(t.HelpText().find("ns, us, ms, s, m/min, h or d") != string::npos);
+    for(const char *arg : {"1P", "1Pi", "1PiB", "1E", "1EB"})
+    {
+        const char *args[] = {"p", "-k", arg};
+        OptionParser op((int)size(args), args);
+        CHECK(op.Parse(k) == OptionBase::Parsed && k.Value() >= 1000000000000000ll);
+    }
+}
+
+// sizes in a blob are of 64 bits, a size beyond the blob is never truncated into a valid one.
+static void test_blob_sizes()
+{
+    Option<string> s("abc", "-s");
+    vector<OptionBase *> opts{&s};
+    string blob = OptionBlob::Save(opts);
+    CHECK(blob.size() == 28 + 12 + 3);
+    CHECK(OptionBlob::Load(opts, blob) == OptionBlob::Loaded && s.Value() == "abc");
+    string bad = blob;
+    bad[28 + 4 + 4] = 1;    // size of value + 2^32
+    CHECK(OptionBlob::Load(opts, bad) == OptionBlob::BlobInvalid);
+    bad = blob;
+    bad[12 + 4] = 1;        // size of blob + 2^32
+    CHECK(OptionBlob::Load(opts, bad) == OptionBlob::BlobInvalid);
+}
+
+// args win over environment variables, which are named by name (before alt_name) of an option.
+static void test_env_precedence()
+{
+    Option<int32_t> g(0, 0, 1000, "--int32_g", "-g"), h(0, "--h-opt"), k(7, "-k");
+    Option<string> s("", "-s");
+    vector<OptionBase *> opts{&g, &h, &k, &s};
+    const char *args[] = {"p", "-s", "arg"};
+    const char *envp[] = {"T_G=100", "T_INT32_G=200", "T_H_OPT=5", "T_S=env", "X_K=9", "T_=1", nullptr};
+    OptionParser op((int)size(args), args);
+    CHECK(op.LoadEnv("T_", envp) == 4);
+    CHECK(op.ParseAll(opts) == 1);
+    CHECK(s.Value() == "arg" && s.GetSource() == OptionBase::FromArgs);
+    CHECK(g.GetSource() == OptionBase::FromEnv && g.Value() == 200 && g.GetLastMatchedName() == "--int32_g");
+    CHECK(h.GetStatus() == OptionBase::Parsed && h.Value() == 5 && h.GetSource() == OptionBase::FromEnv);
+    CHECK(k.GetStatus() == OptionBase::NotFound && k.Value() == 7 && k.GetSource() == OptionBase::FromDefault);
+    g.Reset();
+    CHECK(op.Parse(g) == OptionBase::Parsed && g.GetSource() == OptionBase::FromEnv);
+}
+
+// write content into a file named path in the working directory, for file sources of tests.
+static bool write_file(const char *path, const string &content)
+{
+    FILE *f = fopen(path, "wb");
+    if(!f)
+        return false;
+    const bool ok = fwrite(content.data(), 1, content.size(), f) == content.size();
+    return fclose(f) == 0 && ok;
+}
+
+// config files are under args and environment, with sections, quotes, comments and bare bool names.
+static void test_config_precedence()
+{
+    const char *path = "unit_loyopt_test.cfg";
+    CHECK(write_file(path, "# comment\n; comment\nint32_g = 100\nname = \" a b \"\nverbose\n"
+            "k = 3\n[net]\nport=80\n  host  =  'x'  \nk = 4\n"));
+    Option<int32_t> g(0, "--int32_g"), k(0, "-k"), port(0, "--net.port");
+    Option<string> name("", "--name"), host("", "--net.host");
+    Option<bool> verbose("--verbose");
+    vector<OptionBase *> opts{&g, &k, &port, &name, &host, &verbose};
+    const char *args[] = {"p", "--int32_g", "1"};
+    const char *envp[] = {"T_K=2", nullptr};
+    OptionParser op((int)size(args), args);
+    CHECK(!op.LoadConfig("unit_loyopt_no_such.cfg"));
+    CHECK(op.LoadConfig(path));
+    CHECK(op.LoadEnv("T_", envp) == 1);
+    CHECK(op.ParseAll(opts) == 1);
+    CHECK(g.Value() == 1 && g.GetSource() == OptionBase::FromArgs);
+    CHECK(k.Value() == 2 && k.GetSource() == OptionBase::FromEnv);
+    CHECK(port.Value() == 80 && port.GetSource() == OptionBase::FromFile);
+    CHECK(name.Value() == " a b " && host.Value() == "x" && verbose.Value());
+    const char *args2[] = {"p"};
+    op.Reparse((int)size(args2), args2);
+    op.ParseAll(opts);
+    CHECK(g.Value() == 100 && g.GetSource() == OptionBase::FromFile && k.Value() == 2);
+    remove(path);
+}
+
+// "@path" args are expanded by tokens of response files, nested up to rsp_depth levels.
+static void test_rsp_files()
+{
+    CHECK(write_file("unit_loyopt_a.rsp", "-i 5 \"-s\" 'a b'\n@unit_loyopt_b.rsp"));
+    CHECK(write_file("unit_loyopt_b.rsp", "-l 1\\ 2 @unit_loyopt_c.rsp"));
+    CHECK(write_file("unit_loyopt_c.rsp", "-k 3"));
+    Option<int32_t> i(0, "-i"), k(0, "-k");
+    Option<string> s("", "-s"), l("", "-l");
+    vector<OptionBase *> opts{&i, &k, &s, &l};
+    const char *args[] = {"p", "@unit_loyopt_a.rsp", "@unit_loyopt_none.rsp"};
+    OptionParser op((int)size(args), args, 2);
+    CHECK(op.NumArgs() == 1 + 4 + 2 + 1 + 1);
+    CHECK(op.ParseAll(opts) == 3);
+    CHECK(i.Value() == 5 && s.Value() == "a b" && l.Value() == "1 2" && k.GetStatus() == OptionBase::NotFound);
+    CHECK(op.GetAllUnparsedArgs() == vector<string>({"@unit_loyopt_c.rsp", "@unit_loyopt_none.rsp"}));
+    OptionParser op3((int)size(args), args, 3);
+    CHECK(op3.ParseAll(opts) == 4 && k.Value() == 3 && op3.NumUnparsedArgs() == 1);
+    OptionParser op0((int)size(args), args);
+    CHECK(op0.NumArgs() == size(args) && op0.ParseAll(opts) == 0);
+    remove("unit_loyopt_a.rsp");
+    remove("unit_loyopt_b.rsp");
+    remove("unit_loyopt_c.rsp");
+}
+
+// a choice option takes one of names of it's ChoiceSet, looked up at compile time or runtime.
+enum class Mode { Fast, Safe, Bulk };
+static constexpr Choice<Mode> mode_list[] = { {"fast", Mode::Fast}, {"safe", Mode::Safe}, {"bulk", Mode::Bulk} };
+static constexpr auto mode_choices = MakeChoiceSet(mode_list);
+static_assert(mode_choices.Find("bulk") == 3 && mode_choices.Find("slow") == 0 && mode_choices.Find("") == 0);
+static void test_choice_option()
+{
+    Option<Mode> m(Mode::Safe, mode_choices, "-m", "--mode"), n(Mode::Safe, mode_choices, "-n");
+    Option<Mode> e(Mode::Safe, mode_choices, "--env-mode");
+    vector<OptionBase *> opts{&m, &n, &e};
+    const char *args[] = {"p", "--mode=bulk", "-n", "Fast"};
+    const char *envp[] = {"T_ENV_MODE=fast", nullptr};
+    OptionParser op((int)size(args), args);
+    op.LoadEnv("T_", envp);
+    CHECK(op.ParseAll(opts) == 2);
+    CHECK(m.GetStatus() == OptionBase::Parsed && m.Value() == Mode::Bulk && m.GetValueString() == "bulk");
+    CHECK(n.GetStatus() == OptionBase::ValueInvalid && n.Value() == Mode::Safe);
+    CHECK(e.Value() == Mode::Fast && e.GetSource() == OptionBase::FromEnv);
+    CHECK(m.NameOf(Mode::Fast) == "fast" && m.GetMinValueString() == "fast" && m.GetMaxValueString() == "bulk");
+    CHECK(m.HelpText().find("one of fast|safe|bulk, default = safe") != string::npos);
+    const string blob = OptionBlob::Save(opts);
+    m.Reset();
+    CHECK(m.Value() == Mode::Safe && OptionBlob::Load(opts, blob) == OptionBlob::Loaded && m.Value() == Mode::Bulk);
+}
+
+// output of OptionParser::Complete() for args, "-" if args are not a completion request.
+static string complete(vector<const char *> args, const vector<OptionBase *> &opts)
+{
+    FILE *f = tmpfile();
+    if(!f)
+        return "";
+    string out = OptionParser::Complete((int)args.size(), args.data(), opts, f) ? "" : "-";
+    rewind(f);
+    char buf[4096];
+    for(size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;)
+        out.append(buf, n);
+    fclose(f);
+    return out;
+}
+
+// completion answers names, alt_names or choices without parsing, and prints scripts of shells.
+static void test_complete()
+{
+    Option<bool> v("-v", "--verbose");
+    Option<int32_t> i(0, "-i", "--int32");
+    Option<Mode> m(Mode::Safe, mode_choices, "--mode");
+    vector<OptionBase *> opts{&v, &i, &m};
+    CHECK(complete({"p", "-v"}, opts) == "-");
+    CHECK(complete({"p"}, opts) == "-");
+    CHECK(complete({"p", "--complete", "--"}, opts) == "--int32\n--mode\n--verbose\n");
+    CHECK(complete({"p", "--complete", "--ver"}, opts) == "--verbose\n");
+    CHECK(complete({"p", "--complete", "-x", ""}, opts).find("-i\n") != string::npos);
+    CHECK(complete({"p", "--complete", "--mode", "s"}, opts) == "safe\n");
+    CHECK(complete({"p", "--complete", "--mode="}, opts) == "--mode=fast\n--mode=safe\n--mode=bulk\n");
+    CHECK(complete({"p", "--complete", "-i", ""}, opts).empty());
+    CHECK(complete({"p", "--complete", "-v", "--i"}, opts) == "--int32\n");
+    CHECK(v.GetStatus() == OptionBase::NotParsed);
+    for(const char *shell : {"bash", "zsh", "fish"})
+    {
+        const string script = complete({"/usr/bin/my-tool", "--complete-script", shell}, opts);
+        CHECK(script.find("my_tool_complete") != string::npos && script.find("--complete") != string::npos);
+        CHECK(script.find("@PROG@") == string::npos && script.find("/usr/bin") == string::npos);
+    }
+    CHECK(complete({"p", "--complete-script", "csh"}, opts).empty());
+}
+
+// an OptionSet parses args as OptionParser::ParseAll() of the same options does.
+static constexpr char set_g[] = "-g", set_g_alt[] = "--int32_g", set_a[] = "-a", set_s[] = "--str", set_l[] = "-l";
+static void test_option_set()
+{
+    OptionSet<Opt<int32_t, set_g, set_g_alt>, Opt<bool, set_a>, Opt<string, set_s>, Opt<vector<int32_t>, set_l>> set
+    {
+        make_tuple(50, 0, 100),
+        make_tuple(),
+        make_tuple(string("x")),
+        make_tuple(vector<int32_t>{})
+    };
+    Option<int32_t> g(50, 0, 100, "-g", "--int32_g");
+    Option<bool> a("-a");
+    Option<string> s("x", "--str");
+    Option<vector<int32_t>> l({}, "-l");
+    vector<OptionBase *> opts{&g, &a, &s, &l};
+    const char *args[] = {"p", "--int32_g", "500", "-l", "1,2", "-x", "--str=y", "-g", "3", "-l", "4", "-a"};
+    const char *envp[] = {"T_STR=env", nullptr};
+    OptionParser op1((int)size(args), args), op2((int)size(args), args);
+    CHECK(set.ParseAll(op1) == op2.ParseAll(opts));
+    const auto all = set.All();
+    for(size_t k = 0; k < opts.size(); k++)
+    {
+        CHECK(all[k]->GetStatus() == opts[k]->GetStatus() && all[k]->GetValueString() == opts[k]->GetValueString());
+        CHECK(all[k]->GetLastMatchedName() == opts[k]->GetLastMatchedName());
+    }
+    CHECK(set.Get<0>().Value() == 100 && set.Get<0>().GetStatus() == OptionBase::ClampedMax);
+    CHECK(set.Get<3>().Value() == vector<int32_t>({1, 2, 4}) && set.Get<1>().Value());
+    CHECK(op1.GetAllUnparsedArgs() == op2.GetAllUnparsedArgs() && op1.NumUnparsedArgs() == 3);
+    const char *args2[] = {"p"};
+    OptionParser op3((int)size(args2), args2);
+    op3.LoadEnv("T_", envp);
+    set.ParseAll(op3);
+    CHECK(set.Get<2>().Value() == "env" && set.Get<2>().GetSource() == OptionBase::FromEnv);
+}
+
+// a global StaticOption is constant initialized, so it's ready in dynamic initializers of
+// globals defined before it, and parsed as an Option of the same definition.
+static constexpr string_view static_f_help[] = { "a static option." };
+extern StaticOption<int32_t> unit_static_f;
+extern StaticOption<string_view> unit_static_s;
+static const bool static_ready = unit_static_f.DefaultValue() == 50 && unit_static_f.Max() == 100 &&
+        unit_static_f.GetName() == "-f" && unit_static_s.Value() == "none" && unit_static_s.GetName() == "-s";
+LOYOPTION_CONSTINIT StaticOption<int32_t> unit_static_f(50, 0, 100, "-f", "--int32_f", static_f_help);
+LOYOPTION_CONSTINIT StaticOption<string_view> unit_static_s("none", "-s");
+static void test_static_option()
+{
+    CHECK(static_ready);
+    vector<OptionBase *> opts{&unit_static_f, &unit_static_s};
+    const char *args[] = {"p", "--int32_f", "200", "-s", "abc"};
+    OptionParser op((int)size(args), args);
+    CHECK(op.ParseAll(opts) == 2);
+    CHECK(unit_static_f.Value() == 100 && unit_static_f.GetStatus() == OptionBase::ClampedMax);
+    CHECK(unit_static_s.Value() == "abc" && unit_static_s.Value().data() == args[4]);
+    CHECK(unit_static_f.HelpText().find("a static option.") != string::npos);
+    unit_static_f.Reset();
+    CHECK(unit_static_f.Value() == 50 && unit_static_f.GetStatus() == OptionBase::NotParsed);
+}
+
+// after the 1st parse, Reparse() and ParseAll() of argv sets no larger allocate nothing.
+static void test_reparse_no_alloc()
+{
+    MemoryCounter counter;
+    Option<int32_t> i(0, "-i");
+    Option<string> s("", "-s", "--str");
+    Option<bool> a("-a");
+    Option<vector<int32_t>> l({}, "-l");
+    vector<OptionBase *> opts{&i, &s, &a, &l};
+    const char *args1[] = {"p", "-i", "1", "--str=abc", "--unknown=1", "-al", "1,2,3", "-x", "y"};
+    const char *args2[] = {"p", "-s", "xy", "-i", "2", "-l4"};
+    OptionParser op((int)size(args1), args1, 0, &counter);
+    op.ParseAll(opts);
+    const size_t used = op.BytesUsed(), allocated = counter.Allocated();
+    CHECK(used > 0 && allocated == used);
+    for(int k = 0; k < 3; k++)
+    {
+        op.Reparse((int)size(args1), args1);
+        op.ParseAll(opts);
+        CHECK(op.NumUnparsedArgs() == 3 && l.Value() == vector<int32_t>({1, 2, 3}));
+        op.Reparse((int)size(args2), args2);
+        for(OptionBase *opt : opts)
+            opt->Reset();
+        op.ParseAll(opts);
+        CHECK(i.Value() == 2 && s.Value() == "xy" && !a.Value() && l.Value() == vector<int32_t>({4}));
+    }
+    CHECK(op.BytesUsed() == used && counter.Allocated() == allocated);
+}
+
+// BytesUsed() of a parse sizes a monotonic arena serving the same parse without an upstream.
+static void test_bytes_used_arena()
+{
+    Option<int32_t> i(0, "-i", "--int32");
+    Option<string> s("", "-s");
+    vector<OptionBase *> opts{&i, &s};
+    const char *args[] = {"p", "--int32=5", "-s", "abc", "-xyz", "rest"};
+    const char *envp[] = {"T_S=env", "T_I=1", "U_I=2", nullptr};
+    size_t used;
+    {
+        OptionParser op((int)size(args), args);
+        op.LoadEnv("T_", envp);
+        op.ParseAll(opts);
+        used = op.BytesUsed();
+        CHECK(used > 0 && op.PeakBytesUsed() <= used);
+    }
+    vector<char> buf(used + 64);
+    pmr::monotonic_buffer_resource arena(buf.data(), buf.size(), pmr::null_memory_resource());
+    bool served = true;
+    try
+    {
+        MemoryScope scope(&arena);
+        OptionParser op((int)size(args), args);
+        op.LoadEnv("T_", envp);
+        op.ParseAll(opts);
+        CHECK(op.BytesUsed() == used && i.Value() == 5 && s.Value() == "abc");
+    }
+    catch(const bad_alloc &)
+    {
+        served = false;
+    }
+    CHECK(served);
+}
+
+#if(LOYOPTION_THREADS)
+// long list values parsed in parallel, by the threads of a WorkerPool or a caller's executor,
+// have the same results as parsed in one thread.
+static size_t num_executed = 0;
+static void count_executor(void (*task)(void *), void *arg, unsigned num, void *ctx)
+{
+    num_executed++;
+    static_cast<WorkerPool *>(ctx)->Run(task, arg, num);
+}
+
+static void test_parallel_list()
+{
+    string list;
+    for(int k = 0; k < 20000; k++)
+        list += (k ? "," : "") + to_string(k * 7 - 3000);
+    const char *args[] = {"p", "-l", list.c_str(), "-l", "1,2"};
+    Option<vector<int32_t>> serial({}, -1000, 100000, "-l");
+    OptionParser op((int)size(args), args);
+    op.Parse(serial);
+    CHECK(serial.GetStatus() == OptionBase::ClampedMin && serial.Value().size() == 20002);
+
+    WorkerPool pool(3);
+    for(int run = 0; run < 20; run++)
+    {
+        Option<vector<int32_t>> shared({}, -1000, 100000, "-l"), own({}, -1000, 100000, "-l");
+        shared.SetParallel(1024, 100, 4);
+        own.SetParallel(1024, 100, 4);
+        own.SetParallelExecutor(&count_executor, &pool);
+        OptionParser pp((int)size(args), args);
+        pp.Parse(shared);
+        pp.Parse(own);
+        CHECK(shared.Value() == serial.Value() && shared.GetStatus() == serial.GetStatus());
+        CHECK(own.Value() == serial.Value() && own.GetStatus() == serial.GetStatus());
+    }
+    CHECK(num_executed == 20);
+    const string bad_list = list + ",x," + list;
+    const char *bad_args[] = {"p", "-l", bad_list.c_str()};
+    Option<vector<int32_t>> bad({7}, "-l");
+    bad.SetParallel(1024, 100, 4);
+    bad.SetParallelExecutor(&count_executor, &pool);
+    OptionParser bp((int)size(bad_args), bad_args);
+    CHECK(bp.Parse(bad) == OptionBase::ValueInvalid && bad.Value() == vector<int32_t>{7});
+}
+#endif
+
+int main()
+{
+    test_numeric();
+    test_merged_flags();
+    test_units();
+    test_format_and_blob();
+    test_stream_as_parse_all();
+    test_parse_as_parse_all();
+    test_unparsed_split_args();
+    test_help_text_cache();
+    test_hex_units();
+    test_float_limits();
+    test_prefix_match();
+    test_ambiguous_fallback();
+    test_help_lines_pool();
+    test_live_options_reclaim();
+    test_reparse_options();
+    test_env_bool();
+#if(LOYOPTION_OBSERVER)
+    test_observers();
+#endif
+    test_overflow_clamp();
+    test_command_dispatch();
+    test_unit_help();
+    test_blob_sizes();
+    test_env_precedence();
+    test_config_precedence();
+    test_rsp_files();
+    test_choice_option();
+    test_complete();
+    test_option_set();
+    test_static_option();
+    test_reparse_no_alloc();
+    test_bytes_used_arena();
+#if(LOYOPTION_THREADS)
+    test_parallel_list();
+#endif
+    printf("%d checks, %d failed\n", num_checks, num_failed);
+    return num_failed ? 1 : 0;
+}